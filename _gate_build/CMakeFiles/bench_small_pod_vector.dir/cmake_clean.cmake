@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_small_pod_vector.dir/bench_small_pod_vector.cpp.o"
+  "CMakeFiles/bench_small_pod_vector.dir/bench_small_pod_vector.cpp.o.d"
+  "bench_small_pod_vector"
+  "bench_small_pod_vector.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_small_pod_vector.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_small_pod_vector_compare.dir/bench_small_pod_vector_compare.cpp.o"
+  "CMakeFiles/bench_small_pod_vector_compare.dir/bench_small_pod_vector_compare.cpp.o.d"
+  "bench_small_pod_vector_compare"
+  "bench_small_pod_vector_compare.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_small_pod_vector_compare.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
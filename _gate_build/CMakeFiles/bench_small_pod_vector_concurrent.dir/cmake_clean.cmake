@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_small_pod_vector_concurrent.dir/bench_small_pod_vector_concurrent.cpp.o"
+  "CMakeFiles/bench_small_pod_vector_concurrent.dir/bench_small_pod_vector_concurrent.cpp.o.d"
+  "bench_small_pod_vector_concurrent"
+  "bench_small_pod_vector_concurrent.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_small_pod_vector_concurrent.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_small_pod_vector_flat.dir/bench_small_pod_vector_flat.cpp.o"
+  "CMakeFiles/bench_small_pod_vector_flat.dir/bench_small_pod_vector_flat.cpp.o.d"
+  "bench_small_pod_vector_flat"
+  "bench_small_pod_vector_flat.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_small_pod_vector_flat.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_small_pod_vector_segmented.dir/bench_small_pod_vector_segmented.cpp.o"
+  "CMakeFiles/bench_small_pod_vector_segmented.dir/bench_small_pod_vector_segmented.cpp.o.d"
+  "bench_small_pod_vector_segmented"
+  "bench_small_pod_vector_segmented.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_small_pod_vector_segmented.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_small_pod_vector_serialize.dir/bench_small_pod_vector_serialize.cpp.o"
+  "CMakeFiles/bench_small_pod_vector_serialize.dir/bench_small_pod_vector_serialize.cpp.o.d"
+  "bench_small_pod_vector_serialize"
+  "bench_small_pod_vector_serialize.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_small_pod_vector_serialize.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_small_pod_vector_simd.dir/bench_small_pod_vector_simd.cpp.o"
+  "CMakeFiles/bench_small_pod_vector_simd.dir/bench_small_pod_vector_simd.cpp.o.d"
+  "bench_small_pod_vector_simd"
+  "bench_small_pod_vector_simd.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_small_pod_vector_simd.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
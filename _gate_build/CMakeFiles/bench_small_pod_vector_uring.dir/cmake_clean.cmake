@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_small_pod_vector_uring.dir/bench_small_pod_vector_uring.cpp.o"
+  "CMakeFiles/bench_small_pod_vector_uring.dir/bench_small_pod_vector_uring.cpp.o.d"
+  "bench_small_pod_vector_uring"
+  "bench_small_pod_vector_uring.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_small_pod_vector_uring.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,8 @@
+/* generated by CMake */
+
+#pragma GCC system_header
+#ifdef __cplusplus
+#include <gtest/gtest.h>
+#include <cstring>
+#include <algorithm>
+#endif // __cplusplus
@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/_gate_build/CMakeFiles/test_small_pod_vector_simd_.dir/cmake_pch.hxx.cxx" "CMakeFiles/test_small_pod_vector_simd_.dir/cmake_pch.hxx.gch" "gcc" "CMakeFiles/test_small_pod_vector_simd_.dir/cmake_pch.hxx.gch.d"
+  "/root/repo/_gate_build/CMakeFiles/test_small_pod_vector_simd_.dir/cmake_pch.hxx" "CMakeFiles/test_small_pod_vector_simd_.dir/cmake_pch.hxx.gch" "gcc" "CMakeFiles/test_small_pod_vector_simd_.dir/cmake_pch.hxx.gch.d"
+  "/root/repo/test_small_pod_vector_simd_.cpp" "CMakeFiles/test_small_pod_vector_simd_.dir/test_small_pod_vector_simd_.cpp.o" "gcc" "CMakeFiles/test_small_pod_vector_simd_.dir/test_small_pod_vector_simd_.cpp.o.d"
+  "/root/repo/_gate_build/CMakeFiles/test_small_pod_vector_simd_.dir/cmake_pch.hxx" "CMakeFiles/test_small_pod_vector_simd_.dir/test_small_pod_vector_simd_.cpp.o" "gcc" "CMakeFiles/test_small_pod_vector_simd_.dir/test_small_pod_vector_simd_.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,14 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_small_pod_vector_simd_.dir/cmake_pch.hxx.gch"
+  "CMakeFiles/test_small_pod_vector_simd_.dir/cmake_pch.hxx.gch.d"
+  "CMakeFiles/test_small_pod_vector_simd_.dir/test_small_pod_vector_simd_.cpp.o"
+  "CMakeFiles/test_small_pod_vector_simd_.dir/test_small_pod_vector_simd_.cpp.o.d"
+  "test_small_pod_vector_simd_"
+  "test_small_pod_vector_simd_.pdb"
+  "test_small_pod_vector_simd_[1]_tests.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_small_pod_vector_simd_.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,17 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/_gate_build
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+include("/root/repo/_gate_build/test_small_pod_vector_[1]_include.cmake")
+include("/root/repo/_gate_build/test_small_pod_vector_allocators_[1]_include.cmake")
+include("/root/repo/_gate_build/test_small_pod_vector_simd_[1]_include.cmake")
+include("/root/repo/_gate_build/test_small_pod_vector_stats_[1]_include.cmake")
+include("/root/repo/_gate_build/test_small_pod_vector_profiler_[1]_include.cmake")
+include("/root/repo/_gate_build/test_small_pod_vector_concurrent_[1]_include.cmake")
+include("/root/repo/_gate_build/test_small_pod_vector_segmented_[1]_include.cmake")
+include("/root/repo/_gate_build/test_small_pod_vector_serialize_[1]_include.cmake")
+include("/root/repo/_gate_build/test_small_pod_vector_io_[1]_include.cmake")
+include("/root/repo/_gate_build/test_small_pod_vector_uring_[1]_include.cmake")
+include("/root/repo/_gate_build/test_small_pod_vector_flat_[1]_include.cmake")
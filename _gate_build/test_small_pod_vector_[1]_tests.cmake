@@ -0,0 +1,41 @@
+add_test([=[TestCaseName.smallpod]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.smallpod2]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod2]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod2]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.smallpod3]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod3]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod3]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.smallpod5]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod5]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod5]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.smallpod6]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod6]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod6]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.smallpod8]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod8]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod8]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.smallpod7]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod7]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod7]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.smallpod9]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod9]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod9]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.smallpod10]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod10]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod10]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.smallpod11]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod11]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod11]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.smallpod12]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod12]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod12]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.smallpod13]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod13]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod13]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.smallpod14]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod14]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod14]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.smallpod15]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod15]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod15]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.smallpod16]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod16]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod16]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.smallpod17]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod17]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod17]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.smallpod18]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod18]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod18]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.smallpod19]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod19]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod19]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.smallpod20]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod20]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod20]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.smallpod21]=]  /root/repo/_gate_build/test_small_pod_vector_ [==[--gtest_filter=TestCaseName.smallpod21]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.smallpod21]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+set(  test_small_pod_vector__TESTS TestCaseName.smallpod TestCaseName.smallpod2 TestCaseName.smallpod3 TestCaseName.smallpod5 TestCaseName.smallpod6 TestCaseName.smallpod8 TestCaseName.smallpod7 TestCaseName.smallpod9 TestCaseName.smallpod10 TestCaseName.smallpod11 TestCaseName.smallpod12 TestCaseName.smallpod13 TestCaseName.smallpod14 TestCaseName.smallpod15 TestCaseName.smallpod16 TestCaseName.smallpod17 TestCaseName.smallpod18 TestCaseName.smallpod19 TestCaseName.smallpod20 TestCaseName.smallpod21)
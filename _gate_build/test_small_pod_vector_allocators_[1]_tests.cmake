@@ -0,0 +1,13 @@
+add_test([=[TestCaseName.pool1]=]  /root/repo/_gate_build/test_small_pod_vector_allocators_ [==[--gtest_filter=TestCaseName.pool1]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.pool1]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.pool2]=]  /root/repo/_gate_build/test_small_pod_vector_allocators_ [==[--gtest_filter=TestCaseName.pool2]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.pool2]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.pool3]=]  /root/repo/_gate_build/test_small_pod_vector_allocators_ [==[--gtest_filter=TestCaseName.pool3]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.pool3]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.arena1]=]  /root/repo/_gate_build/test_small_pod_vector_allocators_ [==[--gtest_filter=TestCaseName.arena1]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.arena1]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.mmap1]=]  /root/repo/_gate_build/test_small_pod_vector_allocators_ [==[--gtest_filter=TestCaseName.mmap1]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.mmap1]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.mmap2]=]  /root/repo/_gate_build/test_small_pod_vector_allocators_ [==[--gtest_filter=TestCaseName.mmap2]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.mmap2]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+set(  test_small_pod_vector_allocators__TESTS TestCaseName.pool1 TestCaseName.pool2 TestCaseName.pool3 TestCaseName.arena1 TestCaseName.mmap1 TestCaseName.mmap2)
@@ -0,0 +1,5 @@
+add_test([=[TestCaseName.concurrent1]=]  /root/repo/_gate_build/test_small_pod_vector_concurrent_ [==[--gtest_filter=TestCaseName.concurrent1]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.concurrent1]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.concurrent2]=]  /root/repo/_gate_build/test_small_pod_vector_concurrent_ [==[--gtest_filter=TestCaseName.concurrent2]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.concurrent2]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+set(  test_small_pod_vector_concurrent__TESTS TestCaseName.concurrent1 TestCaseName.concurrent2)
@@ -0,0 +1,5 @@
+if(EXISTS "/root/repo/_gate_build/test_small_pod_vector_flat_[1]_tests.cmake")
+  include("/root/repo/_gate_build/test_small_pod_vector_flat_[1]_tests.cmake")
+else()
+  add_test(test_small_pod_vector_flat__NOT_BUILT test_small_pod_vector_flat__NOT_BUILT)
+endif()
@@ -0,0 +1,9 @@
+add_test([=[TestCaseName.flat1]=]  /root/repo/_gate_build/test_small_pod_vector_flat_ [==[--gtest_filter=TestCaseName.flat1]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.flat1]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.flat2]=]  /root/repo/_gate_build/test_small_pod_vector_flat_ [==[--gtest_filter=TestCaseName.flat2]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.flat2]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.flat3]=]  /root/repo/_gate_build/test_small_pod_vector_flat_ [==[--gtest_filter=TestCaseName.flat3]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.flat3]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.flat4]=]  /root/repo/_gate_build/test_small_pod_vector_flat_ [==[--gtest_filter=TestCaseName.flat4]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.flat4]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+set(  test_small_pod_vector_flat__TESTS TestCaseName.flat1 TestCaseName.flat2 TestCaseName.flat3 TestCaseName.flat4)
@@ -0,0 +1,9 @@
+add_test([=[TestCaseName.io1]=]  /root/repo/_gate_build/test_small_pod_vector_io_ [==[--gtest_filter=TestCaseName.io1]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.io1]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.io2]=]  /root/repo/_gate_build/test_small_pod_vector_io_ [==[--gtest_filter=TestCaseName.io2]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.io2]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.io3]=]  /root/repo/_gate_build/test_small_pod_vector_io_ [==[--gtest_filter=TestCaseName.io3]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.io3]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.io4]=]  /root/repo/_gate_build/test_small_pod_vector_io_ [==[--gtest_filter=TestCaseName.io4]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.io4]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+set(  test_small_pod_vector_io__TESTS TestCaseName.io1 TestCaseName.io2 TestCaseName.io3 TestCaseName.io4)
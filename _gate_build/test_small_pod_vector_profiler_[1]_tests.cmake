@@ -0,0 +1,3 @@
+add_test([=[TestCaseName.profiler1]=]  /root/repo/_gate_build/test_small_pod_vector_profiler_ [==[--gtest_filter=TestCaseName.profiler1]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.profiler1]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+set(  test_small_pod_vector_profiler__TESTS TestCaseName.profiler1)
@@ -0,0 +1,5 @@
+add_test([=[TestCaseName.segmented1]=]  /root/repo/_gate_build/test_small_pod_vector_segmented_ [==[--gtest_filter=TestCaseName.segmented1]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.segmented1]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.segmented2]=]  /root/repo/_gate_build/test_small_pod_vector_segmented_ [==[--gtest_filter=TestCaseName.segmented2]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.segmented2]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+set(  test_small_pod_vector_segmented__TESTS TestCaseName.segmented1 TestCaseName.segmented2)
@@ -0,0 +1,9 @@
+add_test([=[TestCaseName.serialize1]=]  /root/repo/_gate_build/test_small_pod_vector_serialize_ [==[--gtest_filter=TestCaseName.serialize1]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.serialize1]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.serialize2]=]  /root/repo/_gate_build/test_small_pod_vector_serialize_ [==[--gtest_filter=TestCaseName.serialize2]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.serialize2]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.serialize3]=]  /root/repo/_gate_build/test_small_pod_vector_serialize_ [==[--gtest_filter=TestCaseName.serialize3]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.serialize3]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.serialize4]=]  /root/repo/_gate_build/test_small_pod_vector_serialize_ [==[--gtest_filter=TestCaseName.serialize4]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.serialize4]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+set(  test_small_pod_vector_serialize__TESTS TestCaseName.serialize1 TestCaseName.serialize2 TestCaseName.serialize3 TestCaseName.serialize4)
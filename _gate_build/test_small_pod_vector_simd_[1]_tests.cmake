@@ -0,0 +1,5 @@
+add_test([=[TestCaseName.simd1]=]  /root/repo/_gate_build/test_small_pod_vector_simd_ [==[--gtest_filter=TestCaseName.simd1]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.simd1]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.simd2]=]  /root/repo/_gate_build/test_small_pod_vector_simd_ [==[--gtest_filter=TestCaseName.simd2]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.simd2]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+set(  test_small_pod_vector_simd__TESTS TestCaseName.simd1 TestCaseName.simd2)
@@ -0,0 +1,5 @@
+add_test([=[TestCaseName.stats1]=]  /root/repo/_gate_build/test_small_pod_vector_stats_ [==[--gtest_filter=TestCaseName.stats1]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.stats1]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.stats2]=]  /root/repo/_gate_build/test_small_pod_vector_stats_ [==[--gtest_filter=TestCaseName.stats2]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.stats2]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+set(  test_small_pod_vector_stats__TESTS TestCaseName.stats1 TestCaseName.stats2)
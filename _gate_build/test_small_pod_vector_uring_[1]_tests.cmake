@@ -0,0 +1,11 @@
+add_test([=[TestCaseName.uring1]=]  /root/repo/_gate_build/test_small_pod_vector_uring_ [==[--gtest_filter=TestCaseName.uring1]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.uring1]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.uring2]=]  /root/repo/_gate_build/test_small_pod_vector_uring_ [==[--gtest_filter=TestCaseName.uring2]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.uring2]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.uring4]=]  /root/repo/_gate_build/test_small_pod_vector_uring_ [==[--gtest_filter=TestCaseName.uring4]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.uring4]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.uring5]=]  /root/repo/_gate_build/test_small_pod_vector_uring_ [==[--gtest_filter=TestCaseName.uring5]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.uring5]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TestCaseName.uring3]=]  /root/repo/_gate_build/test_small_pod_vector_uring_ [==[--gtest_filter=TestCaseName.uring3]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TestCaseName.uring3]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_gate_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+set(  test_small_pod_vector_uring__TESTS TestCaseName.uring1 TestCaseName.uring2 TestCaseName.uring4 TestCaseName.uring5 TestCaseName.uring3)
@@ -0,0 +1,382 @@
+#define ML_SPV_COUNT_COPIES
+
+#include "small_pod_vector.hpp"
+#include "small_pod_vector_allocators.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace
+{
+	size_t allocations = 0;
+
+	// counts every call that hands out a (new or moved) block
+	struct counting_allocator
+	{
+		ml::impl::pod_allocator a;
+
+		using size_type = size_t;
+
+		void* malloc(size_type size)
+		{
+			++allocations;
+			return a.malloc(size);
+		}
+
+		void* realloc(void* mem, size_type old_size, size_type new_size)
+		{
+			++allocations;
+			return a.realloc(mem, old_size, new_size);
+		}
+
+		void free(void* mem)
+		{
+			a.free(mem);
+		}
+	};
+
+	template <typename GrowthPolicy>
+	using growth_vec = ml::small_pod_vector<int, 16, 0, counting_allocator, GrowthPolicy>;
+
+	template <typename Vec>
+	void push_back_growth(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+
+		allocations = 0;
+
+		for (auto _ : state)
+		{
+			Vec vec;
+
+			for (size_t i = 0; i < n; ++i)
+			{
+				vec.push_back(int(i));
+			}
+
+			benchmark::DoNotOptimize(vec.data());
+		}
+
+		state.counters["allocs"] = benchmark::Counter(double(allocations), benchmark::Counter::kAvgIterations);
+		state.SetItemsProcessed(int64_t(state.iterations() * n));
+	}
+
+	// short-lived vectors that spill just past the static capacity
+	template <typename Alloc>
+	void short_lived_spill(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+
+		for (auto _ : state)
+		{
+			ml::small_pod_vector<int, 16, 0, Alloc> vec;
+
+			for (size_t i = 0; i < n; ++i)
+			{
+				vec.push_back(int(i));
+			}
+
+			benchmark::DoNotOptimize(vec.data());
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations()));
+	}
+
+	// ways of appending, reserve tells whether the capacity is reserved up front
+	struct by_push_back
+	{
+		static constexpr bool reserve = false;
+		template <typename Vec> static void add(Vec& vec, int v) { vec.push_back(v); }
+	};
+
+	struct by_emplace_back
+	{
+		static constexpr bool reserve = false;
+		template <typename Vec> static void add(Vec& vec, int v) { vec.emplace_back(v); }
+	};
+
+	// the generic grow path push_back took before it had a fast path
+	struct by_insert_at_end
+	{
+		static constexpr bool reserve = false;
+		template <typename Vec> static void add(Vec& vec, int v) { vec.insert(vec.end(), v); }
+	};
+
+	struct by_reserved_push_back
+	{
+		static constexpr bool reserve = true;
+		template <typename Vec> static void add(Vec& vec, int v) { vec.push_back(v); }
+	};
+
+	struct by_push_back_unchecked
+	{
+		static constexpr bool reserve = true;
+		template <typename Vec> static void add(Vec& vec, int v) { vec.push_back_unchecked(v); }
+	};
+
+	template <typename Vec, typename Append>
+	void append_path(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+
+		for (auto _ : state)
+		{
+			Vec vec;
+
+			if (Append::reserve)
+			{
+				vec.reserve(n);
+			}
+
+			for (size_t i = 0; i < n; ++i)
+			{
+				Append::add(vec, int(i));
+			}
+
+			benchmark::DoNotOptimize(vec.data());
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations() * n));
+	}
+
+	// many small vectors stored in an array, summed in a scan
+	template <typename Vec>
+	void footprint_scan(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+
+		std::vector<Vec> vecs(n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			for (size_t j = 0; j < i % 4; ++j)
+			{
+				vecs[i].push_back(uint16_t(j));
+			}
+		}
+
+		for (auto _ : state)
+		{
+			uint64_t sum = 0;
+			for (const auto& vec : vecs)
+			{
+				for (auto v : vec)
+				{
+					sum += v;
+				}
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+
+		state.counters["bytes_per_vector"] = double(sizeof(Vec));
+		state.counters["array_MB"] = double(sizeof(Vec) * n) / (1024 * 1024);
+		state.SetItemsProcessed(int64_t(state.iterations() * n));
+	}
+
+	// assign(n, value), Arg(1) picks a value with uniform bytes
+	template <typename Vec>
+	void assign_fill(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+		const auto value = state.range(1) ? 0 : 0x01020304;
+
+		Vec vec;
+		vec.reserve(n);
+
+		for (auto _ : state)
+		{
+			vec.assign(n, value);
+			benchmark::DoNotOptimize(vec.data());
+			benchmark::ClobberMemory();
+		}
+
+		state.SetBytesProcessed(int64_t(state.iterations() * n * sizeof(int)));
+	}
+
+	// inserts in the middle, some of which regrow the buffer around the hole
+	template <typename Vec>
+	void insert_middle(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+
+		const auto before = ml::impl::bytes_copied();
+
+		for (auto _ : state)
+		{
+			Vec vec;
+
+			for (size_t i = 0; i < n; ++i)
+			{
+				vec.insert(vec.begin() + vec.size() / 2, int(i));
+			}
+
+			benchmark::DoNotOptimize(vec.data());
+		}
+
+		state.counters["bytes_copied"] = benchmark::Counter(double(ml::impl::bytes_copied() - before), benchmark::Counter::kAvgIterations);
+		state.SetItemsProcessed(int64_t(state.iterations() * n));
+	}
+
+	// reserve on a buffer an eighth full, only the live eighth should move
+	template <typename Vec>
+	void reserve_partial(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+
+		const auto before = ml::impl::bytes_copied();
+
+		for (auto _ : state)
+		{
+			state.PauseTiming();
+			Vec vec(n, 1);
+			vec.resize(n / 8);
+			state.ResumeTiming();
+
+			vec.reserve(2 * n);
+			benchmark::DoNotOptimize(vec.data());
+		}
+
+		state.counters["bytes_copied"] = benchmark::Counter(double(ml::impl::bytes_copied() - before), benchmark::Counter::kAvgIterations);
+		state.counters["live_bytes"] = double(n / 8 * sizeof(int));
+	}
+	// grows a large buffer from empty and scans it, per allocator. the page faults of first touch
+	// are in the growth, the TLB misses in the scan
+	template <class Alloc>
+	void large_grow_scan(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+
+		for (auto _ : state)
+		{
+			ml::small_pod_vector<uint64_t, 16, 0, Alloc, ml::growth::doubling> vec;
+			for (size_t i = 0; i < n; ++i)
+			{
+				vec.push_back(i);
+			}
+
+			uint64_t sum = 0;
+			for (size_t pass = 0; pass < 4; ++pass)
+			{
+				for (size_t i = 0; i < n; i += 61)
+				{
+					sum += vec[(i * 2654435761u) % n];
+				}
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+
+		state.SetBytesProcessed(int64_t(state.iterations() * n * sizeof(uint64_t)));
+	}
+	// a sorted patch list of range(1) single element inserts into range(0) elements, one insert() each
+	// or one insert_many(), then the same positions erased
+	void patch_list(benchmark::State& state)
+	{
+		using vec_type = ml::small_pod_vector<int, 16>;
+
+		const auto n = size_t(state.range(0));
+		const auto k = size_t(state.range(1));
+		const bool batched = state.range(2) != 0;
+
+		const int value = -1;
+		std::vector<size_t> at(k);
+		for (size_t i = 0; i < k; ++i)
+		{
+			at[i] = i * n / k;
+		}
+
+		for (auto _ : state)
+		{
+			state.PauseTiming();
+			vec_type vec(n, 1);
+			std::vector<vec_type::insertion> ranges(k);
+			state.ResumeTiming();
+
+			if (batched)
+			{
+				for (size_t i = 0; i < k; ++i)
+				{
+					ranges[i] = { vec.cbegin() + at[i], &value, &value + 1 };
+				}
+				vec.insert_many(ranges.data(), k);
+
+				std::vector<vec_type::const_iterator> positions(k);
+				for (size_t i = 0; i < k; ++i)
+				{
+					positions[i] = vec.cbegin() + at[i] + i;
+				}
+				vec.erase_many(positions.data(), k);
+			}
+			else
+			{
+				// back to front, so the positions stay valid
+				for (size_t i = k; i-- > 0;)
+				{
+					vec.insert(vec.begin() + at[i], value);
+				}
+				for (size_t i = k; i-- > 0;)
+				{
+					vec.erase(vec.begin() + at[i] + i);
+				}
+			}
+
+			benchmark::DoNotOptimize(vec.data());
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations() * k));
+	}
+}
+
+// allocation count and push_back throughput per growth policy, from just past the static capacity to large
+
+BENCHMARK_TEMPLATE(push_back_growth, growth_vec<ml::growth::tight_spill>)->Arg(17)->Arg(24)->Arg(64)->Range(512, 1 << 20);
+BENCHMARK_TEMPLATE(push_back_growth, growth_vec<ml::growth::doubling>)->Arg(17)->Arg(24)->Arg(64)->Range(512, 1 << 20);
+BENCHMARK_TEMPLATE(push_back_growth, growth_vec<ml::growth::one_and_a_half>)->Arg(17)->Arg(24)->Arg(64)->Range(512, 1 << 20);
+BENCHMARK_TEMPLATE(push_back_growth, growth_vec<ml::growth::page_rounded<>>)->Arg(17)->Arg(24)->Arg(64)->Range(512, 1 << 20);
+BENCHMARK_TEMPLATE(push_back_growth, growth_vec<ml::growth::fixed_chunk<1024>>)->Arg(17)->Arg(24)->Arg(64)->Range(512, 1 << 20);
+
+// pool_allocator against std::malloc for the spill-and-destroy pattern
+
+BENCHMARK_TEMPLATE(short_lived_spill, ml::impl::pod_allocator)->Arg(17)->Arg(40)->Arg(200)->ThreadRange(1, 8);
+BENCHMARK_TEMPLATE(short_lived_spill, ml::impl::pool_allocator)->Arg(17)->Arg(40)->Arg(200)->ThreadRange(1, 8);
+
+// push_back fast path against the generic grow path and std::vector, within the static capacity and beyond
+
+BENCHMARK_TEMPLATE(append_path, std::vector<int>, by_push_back)->Arg(16)->Arg(1024);
+BENCHMARK_TEMPLATE(append_path, ml::small_pod_vector<int, 16>, by_insert_at_end)->Arg(16)->Arg(1024);
+BENCHMARK_TEMPLATE(append_path, ml::small_pod_vector<int, 16>, by_push_back)->Arg(16)->Arg(1024);
+BENCHMARK_TEMPLATE(append_path, ml::small_pod_vector<int, 16>, by_emplace_back)->Arg(16)->Arg(1024);
+BENCHMARK_TEMPLATE(append_path, ml::compact_small_pod_vector<int, 16>, by_push_back)->Arg(16)->Arg(1024);
+BENCHMARK_TEMPLATE(append_path, std::vector<int>, by_reserved_push_back)->Arg(16)->Arg(1024);
+BENCHMARK_TEMPLATE(append_path, ml::small_pod_vector<int, 16>, by_push_back_unchecked)->Arg(16)->Arg(1024);
+
+// header size and scan speed per layout
+
+BENCHMARK_TEMPLATE(footprint_scan, ml::small_pod_vector<uint16_t, 4>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(footprint_scan, ml::compact_small_pod_vector<uint16_t, 4>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(footprint_scan, ml::sso_pod_vector<uint16_t, 16>)->Arg(1 << 10)->Arg(1 << 20);
+
+// bulk fill against std::vector, memset for uniform bytes and the store loop for the rest
+
+BENCHMARK_TEMPLATE(assign_fill, std::vector<int>)->ArgsProduct({ { 64, 4096, 1 << 20 }, { 0, 1 } });
+BENCHMARK_TEMPLATE(assign_fill, ml::small_pod_vector<int, 16>)->ArgsProduct({ { 64, 4096, 1 << 20 }, { 0, 1 } });
+
+// bytes copied by regrowth: live elements only, once, around the hole
+
+BENCHMARK_TEMPLATE(insert_middle, std::vector<int>)->Arg(64)->Arg(1024)->Arg(16384);
+BENCHMARK_TEMPLATE(insert_middle, ml::small_pod_vector<int, 16>)->Arg(64)->Arg(1024)->Arg(16384);
+BENCHMARK_TEMPLATE(insert_middle, growth_vec<ml::growth::doubling>)->Arg(64)->Arg(1024)->Arg(16384);
+BENCHMARK_TEMPLATE(reserve_partial, std::vector<int>)->Arg(1024)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(reserve_partial, ml::small_pod_vector<int, 16>)->Arg(1024)->Arg(1 << 20);
+
+// a patch list applied one insert/erase at a time against insert_many/erase_many
+
+BENCHMARK(patch_list)->ArgsProduct({ { 1 << 16 }, { 16, 256, 4096 }, { 0, 1 } });
+
+// large buffers: std::realloc against mmap/mremap, with and without huge pages
+
+#if defined(__linux__)
+BENCHMARK_TEMPLATE(large_grow_scan, ml::impl::pod_allocator)->Arg(1 << 20)->Arg(1 << 24);
+BENCHMARK_TEMPLATE(large_grow_scan, ml::impl::mmap_allocator<(1 << 21), ml::impl::mmap_options::none>)->Arg(1 << 20)->Arg(1 << 24);
+BENCHMARK_TEMPLATE(large_grow_scan, ml::impl::mmap_allocator<(1 << 21), ml::impl::mmap_options::huge_pages>)->Arg(1 << 20)->Arg(1 << 24);
+BENCHMARK_TEMPLATE(large_grow_scan, ml::impl::mmap_allocator<(1 << 21), ml::impl::mmap_options::huge_pages | ml::impl::mmap_options::populate>)->Arg(1 << 20)->Arg(1 << 24);
+#endif
@@ -0,0 +1,252 @@
+// small_pod_vector against std::vector and, when their headers are found, boost::container::small_vector
+// and absl::InlinedVector (both header only for what's used here)
+//
+// for tracking over time: --benchmark_out=compare.json --benchmark_out_format=json
+
+#include "small_pod_vector.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<boost/container/small_vector.hpp>)
+#include <boost/container/small_vector.hpp>
+#define ML_SPV_BENCH_BOOST 1
+#endif
+#if __has_include(<absl/container/inlined_vector.h>)
+#include <absl/container/inlined_vector.h>
+#define ML_SPV_BENCH_ABSL 1
+#endif
+#endif
+
+namespace
+{
+	// an element of Bytes bytes
+	template <size_t Bytes>
+	struct blob
+	{
+		uint32_t v[Bytes / 4];
+	};
+
+	template <typename T>
+	T make(size_t i)
+	{
+		return T(i);
+	}
+
+	template <>
+	blob<32> make<blob<32>>(size_t i)
+	{
+		blob<32> b = {};
+		b.v[0] = uint32_t(i);
+		return b;
+	}
+
+	template <typename Vec>
+	Vec make_vec(size_t n)
+	{
+		Vec vec;
+		for (size_t i = 0; i < n; ++i)
+		{
+			vec.push_back(make<typename Vec::value_type>(i));
+		}
+		return vec;
+	}
+
+	template <typename Vec>
+	void push_back(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+
+		for (auto _ : state)
+		{
+			Vec vec;
+			for (size_t i = 0; i < n; ++i)
+			{
+				vec.push_back(make<typename Vec::value_type>(i));
+			}
+			benchmark::DoNotOptimize(vec.data());
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations() * n));
+	}
+
+	template <typename Vec>
+	void insert_front(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+
+		for (auto _ : state)
+		{
+			Vec vec;
+			for (size_t i = 0; i < n; ++i)
+			{
+				vec.insert(vec.begin(), make<typename Vec::value_type>(i));
+			}
+			benchmark::DoNotOptimize(vec.data());
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations() * n));
+	}
+
+	template <typename Vec>
+	void insert_middle(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+
+		for (auto _ : state)
+		{
+			Vec vec;
+			for (size_t i = 0; i < n; ++i)
+			{
+				vec.insert(vec.begin() + vec.size() / 2, make<typename Vec::value_type>(i));
+			}
+			benchmark::DoNotOptimize(vec.data());
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations() * n));
+	}
+
+	// removes ranges of 8 from the middle until empty, the copy that refills it isn't timed
+	template <typename Vec>
+	void erase_ranges(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+		const auto source = make_vec<Vec>(n);
+
+		for (auto _ : state)
+		{
+			state.PauseTiming();
+			Vec vec(source);
+			state.ResumeTiming();
+
+			while (!vec.empty())
+			{
+				const auto count = std::min<size_t>(8, vec.size());
+				const auto first = vec.begin() + (vec.size() - count) / 2;
+				vec.erase(first, first + count);
+			}
+			benchmark::DoNotOptimize(vec.data());
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations() * n));
+	}
+
+	template <typename Vec>
+	void copy_construct(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+		const auto source = make_vec<Vec>(n);
+
+		for (auto _ : state)
+		{
+			Vec vec(source);
+			benchmark::DoNotOptimize(vec.data());
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations() * n));
+	}
+
+	// moves back and forth, a static buffer has to be copied
+	template <typename Vec>
+	void move_construct(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+		auto vec = make_vec<Vec>(n);
+
+		for (auto _ : state)
+		{
+			Vec moved(std::move(vec));
+			benchmark::DoNotOptimize(moved.data());
+			vec = std::move(moved);
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations() * n));
+	}
+
+	// fills a fresh vector up to just below, at and just past its static capacity
+	template <typename Vec>
+	void spill(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+
+		for (auto _ : state)
+		{
+			Vec vec;
+			for (size_t i = 0; i < n; ++i)
+			{
+				vec.push_back(make<typename Vec::value_type>(i));
+			}
+
+			// and back below it
+			vec.erase(vec.begin() + 1, vec.end());
+			benchmark::DoNotOptimize(vec.data());
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations() * n));
+	}
+
+	template <typename T>
+	using std_vec = std::vector<T>;
+
+	template <typename T, size_t N>
+	using spv = ml::small_pod_vector<T, N>;
+
+	// reverts to the static buffer on the way back down
+	template <typename T, size_t N>
+	using spv_revert = ml::small_pod_vector<T, N, N / 2>;
+
+	template <typename T, size_t N>
+	using spv_compact = ml::compact_small_pod_vector<T, N>;
+
+#ifdef ML_SPV_BENCH_BOOST
+	template <typename T, size_t N>
+	using boost_small = boost::container::small_vector<T, N>;
+#endif
+
+#ifdef ML_SPV_BENCH_ABSL
+	template <typename T, size_t N>
+	using absl_inlined = absl::InlinedVector<T, N>;
+#endif
+}
+
+// every operation per element type and static capacity, the sizes straddle the static capacity
+
+#define ML_SPV_BENCH_SIZES(N) ->Arg(N / 2)->Arg(N)->Arg(N + 1)->Arg(4 * N)->Arg(1024)
+#define ML_SPV_BENCH_SPILL(N) ->Arg(N - 1)->Arg(N)->Arg(N + 1)
+
+#define ML_SPV_BENCH_CONTAINER(N, ...) \
+	BENCHMARK_TEMPLATE(push_back, __VA_ARGS__) ML_SPV_BENCH_SIZES(N); \
+	BENCHMARK_TEMPLATE(insert_front, __VA_ARGS__) ML_SPV_BENCH_SIZES(N); \
+	BENCHMARK_TEMPLATE(insert_middle, __VA_ARGS__) ML_SPV_BENCH_SIZES(N); \
+	BENCHMARK_TEMPLATE(erase_ranges, __VA_ARGS__) ML_SPV_BENCH_SIZES(N); \
+	BENCHMARK_TEMPLATE(copy_construct, __VA_ARGS__) ML_SPV_BENCH_SIZES(N); \
+	BENCHMARK_TEMPLATE(move_construct, __VA_ARGS__) ML_SPV_BENCH_SIZES(N); \
+	BENCHMARK_TEMPLATE(spill, __VA_ARGS__) ML_SPV_BENCH_SPILL(N);
+
+#ifdef ML_SPV_BENCH_BOOST
+#define ML_SPV_BENCH_BOOST_CONTAINER(T, N) ML_SPV_BENCH_CONTAINER(N, boost_small<T, N>)
+#else
+#define ML_SPV_BENCH_BOOST_CONTAINER(T, N)
+#endif
+
+#ifdef ML_SPV_BENCH_ABSL
+#define ML_SPV_BENCH_ABSL_CONTAINER(T, N) ML_SPV_BENCH_CONTAINER(N, absl_inlined<T, N>)
+#else
+#define ML_SPV_BENCH_ABSL_CONTAINER(T, N)
+#endif
+
+#define ML_SPV_BENCH_ALL(T, N) \
+	ML_SPV_BENCH_CONTAINER(N, std_vec<T>) \
+	ML_SPV_BENCH_CONTAINER(N, spv<T, N>) \
+	ML_SPV_BENCH_CONTAINER(N, spv_revert<T, N>) \
+	ML_SPV_BENCH_CONTAINER(N, spv_compact<T, N>) \
+	ML_SPV_BENCH_BOOST_CONTAINER(T, N) \
+	ML_SPV_BENCH_ABSL_CONTAINER(T, N)
+
+ML_SPV_BENCH_ALL(int32_t, 8)
+ML_SPV_BENCH_ALL(blob<32>, 8)
+ML_SPV_BENCH_ALL(int32_t, 32)
+ML_SPV_BENCH_ALL(uint8_t, 32)
@@ -0,0 +1,116 @@
+#include "small_pod_vector_concurrent.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <mutex>
+#include <thread>
+
+namespace
+{
+	// every thread appends this many per iteration, into one shared collector
+	const size_t batch = 256;
+
+	ml::concurrent_pod_vector<uint64_t, 64>* shared_concurrent = nullptr;
+
+	void concurrent_push_back(benchmark::State& state)
+	{
+		if (state.thread_index() == 0)
+		{
+			shared_concurrent = new ml::concurrent_pod_vector<uint64_t, 64>;
+		}
+
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < batch; ++i)
+			{
+				shared_concurrent->push_back(i);
+			}
+		}
+
+		if (state.thread_index() == 0)
+		{
+			delete shared_concurrent;
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations() * batch));
+	}
+
+	// the same, a batch reserved with one fetch_add
+	void concurrent_append(benchmark::State& state)
+	{
+		if (state.thread_index() == 0)
+		{
+			shared_concurrent = new ml::concurrent_pod_vector<uint64_t, 64>;
+		}
+
+		uint64_t values[batch] = {};
+
+		for (auto _ : state)
+		{
+			shared_concurrent->append(values, batch);
+		}
+
+		if (state.thread_index() == 0)
+		{
+			delete shared_concurrent;
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations() * batch));
+	}
+
+	// what it replaces: a mutex around push_back
+	std::mutex shared_mutex;
+	ml::small_pod_vector<uint64_t, 64>* shared_locked = nullptr;
+
+	void locked_push_back(benchmark::State& state)
+	{
+		if (state.thread_index() == 0)
+		{
+			shared_locked = new ml::small_pod_vector<uint64_t, 64>;
+		}
+
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < batch; ++i)
+			{
+				std::lock_guard<std::mutex> lock(shared_mutex);
+				shared_locked->push_back(i);
+			}
+		}
+
+		if (state.thread_index() == 0)
+		{
+			delete shared_locked;
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations() * batch));
+	}
+
+	// collection followed by the conversion to a plain vector, single threaded
+	void flatten(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+
+		ml::concurrent_pod_vector<uint64_t, 64> vec;
+		for (size_t i = 0; i < n; ++i)
+		{
+			vec.push_back(i);
+		}
+
+		for (auto _ : state)
+		{
+			auto flat = vec.to_vector();
+			benchmark::DoNotOptimize(flat.data());
+		}
+
+		state.SetBytesProcessed(int64_t(state.iterations() * n * sizeof(uint64_t)));
+	}
+}
+
+// from 1 to all cores, a fixed number of iterations bounds the collected size
+
+BENCHMARK(concurrent_push_back)->Iterations(2000)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(concurrent_append)->Iterations(2000)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(locked_push_back)->Iterations(2000)->ThreadRange(1, 64)->UseRealTime();
+
+BENCHMARK(flatten)->Arg(1 << 10)->Arg(1 << 20);
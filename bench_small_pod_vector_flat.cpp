@@ -0,0 +1,158 @@
+// small_flat_set / small_flat_map against the node based and hashed standard containers, 4 to 256 keys
+
+#include "small_pod_vector_flat.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <random>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+	// n distinct keys in random order
+	std::vector<int> make_keys(size_t n)
+	{
+		std::vector<int> keys(n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			keys[i] = int(i * 2 + 1);
+		}
+		std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+		return keys;
+	}
+
+	// lookups, half of them hits (odd), half misses (even)
+	std::vector<int> make_queries(size_t n)
+	{
+		std::mt19937 rng(7);
+		std::uniform_int_distribution<int> key(0, int(n * 2));
+		std::vector<int> queries(1024);
+		for (auto& q : queries)
+		{
+			q = key(rng);
+		}
+		return queries;
+	}
+
+	template <typename K>
+	void add(std::set<K>& set, K key) { set.insert(key); }
+
+	template <typename K>
+	void add(std::unordered_set<K>& set, K key) { set.insert(key); }
+
+	template <typename K, size_t N>
+	void add(ml::small_flat_set<K, N>& set, K key) { set.insert(key); }
+
+	template <typename K, typename V>
+	void add(std::map<K, V>& map, K key) { map.emplace(key, V(key)); }
+
+	template <typename K, typename V>
+	void add(std::unordered_map<K, V>& map, K key) { map.emplace(key, V(key)); }
+
+	template <typename K, typename V, size_t N>
+	void add(ml::small_flat_map<K, V, N>& map, K key) { map.try_emplace(key, V(key)); }
+
+	template <typename Table>
+	void lookup(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+
+		Table table;
+		for (auto k : make_keys(n))
+		{
+			add(table, k);
+		}
+		const auto queries = make_queries(n);
+
+		for (auto _ : state)
+		{
+			size_t found = 0;
+			for (auto q : queries)
+			{
+				found += table.count(q);
+			}
+			benchmark::DoNotOptimize(found);
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations() * queries.size()));
+	}
+
+	// one key at a time, the way tables are usually filled
+	template <typename Table>
+	void build(benchmark::State& state)
+	{
+		const auto keys = make_keys(size_t(state.range(0)));
+
+		for (auto _ : state)
+		{
+			Table table;
+			for (auto k : keys)
+			{
+				add(table, k);
+			}
+			benchmark::DoNotOptimize(&table);
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations() * keys.size()));
+	}
+
+	// all keys at once: appended, then sorted once
+	template <typename Table>
+	void build_bulk(benchmark::State& state)
+	{
+		const auto keys = make_keys(size_t(state.range(0)));
+
+		for (auto _ : state)
+		{
+			Table table(keys.begin(), keys.end());
+			benchmark::DoNotOptimize(&table);
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations() * keys.size()));
+	}
+
+	template <typename Map>
+	void build_bulk_map(benchmark::State& state)
+	{
+		std::vector<std::pair<int, int>> entries;
+		for (auto k : make_keys(size_t(state.range(0))))
+		{
+			entries.emplace_back(k, k);
+		}
+
+		for (auto _ : state)
+		{
+			Map map(entries.begin(), entries.end());
+			benchmark::DoNotOptimize(&map);
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations() * entries.size()));
+	}
+
+	using flat_set = ml::small_flat_set<int, 32>;
+	using flat_map = ml::small_flat_map<int, int, 32>;
+}
+
+#define ML_SPV_BENCH_TABLE_SIZES ->RangeMultiplier(2)->Range(4, 256)
+
+#define ML_SPV_BENCH_TABLE(...) \
+	BENCHMARK_TEMPLATE(lookup, __VA_ARGS__) ML_SPV_BENCH_TABLE_SIZES; \
+	BENCHMARK_TEMPLATE(build, __VA_ARGS__) ML_SPV_BENCH_TABLE_SIZES;
+
+ML_SPV_BENCH_TABLE(flat_set)
+ML_SPV_BENCH_TABLE(std::set<int>)
+ML_SPV_BENCH_TABLE(std::unordered_set<int>)
+ML_SPV_BENCH_TABLE(flat_map)
+ML_SPV_BENCH_TABLE(std::map<int, int>)
+ML_SPV_BENCH_TABLE(std::unordered_map<int, int>)
+
+BENCHMARK_TEMPLATE(build_bulk, flat_set) ML_SPV_BENCH_TABLE_SIZES;
+BENCHMARK_TEMPLATE(build_bulk, std::set<int>) ML_SPV_BENCH_TABLE_SIZES;
+BENCHMARK_TEMPLATE(build_bulk_map, flat_map) ML_SPV_BENCH_TABLE_SIZES;
+BENCHMARK_TEMPLATE(build_bulk_map, std::map<int, int>) ML_SPV_BENCH_TABLE_SIZES;
+
+BENCHMARK_MAIN();
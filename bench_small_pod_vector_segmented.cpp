@@ -0,0 +1,112 @@
+#include "small_pod_vector_segmented.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	void append(ml::segmented_pod_vector<uint64_t, 64>& vec, const uint64_t* p, size_t n)
+	{
+		vec.append(p, n);
+	}
+
+	void append(ml::small_pod_vector<uint64_t, 64>& vec, const uint64_t* p, size_t n)
+	{
+		std::memcpy(vec.append_uninitialized(n), p, n * sizeof(uint64_t));
+	}
+
+	void append(std::vector<uint64_t>& vec, const uint64_t* p, size_t n)
+	{
+		vec.insert(vec.end(), p, p + n);
+	}
+
+	// filling without reserve: the contiguous vectors copy everything on every doubling, the segmented one nothing
+	template <typename Vec>
+	void ingest(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+
+		for (auto _ : state)
+		{
+			Vec vec;
+			for (size_t i = 0; i < n; ++i)
+			{
+				vec.push_back(i);
+			}
+			benchmark::DoNotOptimize(&vec.back());
+		}
+
+		state.SetBytesProcessed(int64_t(state.iterations() * n * sizeof(uint64_t)));
+	}
+
+	// the same in runs of 4k
+	template <typename Vec>
+	void ingest_runs(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+		const size_t run = 4096;
+		std::vector<uint64_t> values(run, 42);
+
+		for (auto _ : state)
+		{
+			Vec vec;
+			for (size_t i = 0; i < n; i += run)
+			{
+				append(vec, values.data(), run);
+			}
+			benchmark::DoNotOptimize(&vec.back());
+		}
+
+		state.SetBytesProcessed(int64_t(state.iterations() * n * sizeof(uint64_t)));
+	}
+
+	// reading back through the iterators, a segment boundary costs a lookup
+	void iterate(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+
+		ml::segmented_pod_vector<uint64_t, 64> vec;
+		vec.resize(n, 1);
+
+		for (auto _ : state)
+		{
+			uint64_t sum = 0;
+			for (auto v : vec)
+			{
+				sum += v;
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+
+		state.SetBytesProcessed(int64_t(state.iterations() * n * sizeof(uint64_t)));
+	}
+
+	void flatten(benchmark::State& state)
+	{
+		const auto n = size_t(state.range(0));
+
+		ml::segmented_pod_vector<uint64_t, 64> vec;
+		vec.resize(n, 1);
+
+		for (auto _ : state)
+		{
+			auto flat = vec.to_vector();
+			benchmark::DoNotOptimize(flat.data());
+		}
+
+		state.SetBytesProcessed(int64_t(state.iterations() * n * sizeof(uint64_t)));
+	}
+}
+
+BENCHMARK_TEMPLATE(ingest, ml::segmented_pod_vector<uint64_t, 64>)->Range(1 << 10, 1 << 24);
+BENCHMARK_TEMPLATE(ingest, ml::small_pod_vector<uint64_t, 64>)->Range(1 << 10, 1 << 24);
+BENCHMARK_TEMPLATE(ingest, std::vector<uint64_t>)->Range(1 << 10, 1 << 24);
+
+BENCHMARK_TEMPLATE(ingest_runs, ml::segmented_pod_vector<uint64_t, 64>)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(ingest_runs, ml::small_pod_vector<uint64_t, 64>)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(ingest_runs, std::vector<uint64_t>)->Range(1 << 12, 1 << 24);
+
+BENCHMARK(iterate)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(flatten)->Arg(1 << 10)->Arg(1 << 20);
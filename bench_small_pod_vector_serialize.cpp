@@ -0,0 +1,92 @@
+#include "small_pod_vector_serialize.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace
+{
+	// many vectors of 0 to 63 elements, serialized back to back
+	ml::small_pod_vector<unsigned char> make_blobs(size_t count)
+	{
+		ml::small_pod_vector<unsigned char> bytes;
+		ml::small_pod_vector<uint32_t, 16> vec;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			vec.resize((i * 2654435761u) % 64, uint32_t(i));
+			ml::serialize::append(bytes, vec);
+		}
+		return bytes;
+	}
+
+	// views into the buffer, each vector touched once
+	void load_views(benchmark::State& state)
+	{
+		const auto bytes = make_blobs(size_t(state.range(0)));
+
+		for (auto _ : state)
+		{
+			ml::serialize::blob_reader reader(bytes.data(), bytes.size());
+			ml::small_pod_vector_view<uint32_t> view;
+
+			uint64_t sum = 0;
+			while (reader.next(view))
+			{
+				sum += view.empty() ? 0 : view.back();
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+
+		state.SetBytesProcessed(int64_t(state.iterations() * bytes.size()));
+	}
+
+	// the copy path: every vector materialized into an owning one
+	void load_copies(benchmark::State& state)
+	{
+		const auto bytes = make_blobs(size_t(state.range(0)));
+
+		std::vector<ml::small_pod_vector<uint32_t, 16>> vecs;
+		vecs.reserve(size_t(state.range(0)));
+
+		for (auto _ : state)
+		{
+			vecs.clear();
+
+			ml::serialize::blob_reader reader(bytes.data(), bytes.size());
+			ml::small_pod_vector_view<uint32_t> view;
+
+			while (reader.next(view))
+			{
+				vecs.push_back(view.materialize<ml::small_pod_vector<uint32_t, 16>>());
+			}
+			benchmark::DoNotOptimize(vecs.data());
+		}
+
+		state.SetBytesProcessed(int64_t(state.iterations() * bytes.size()));
+	}
+
+	void store(benchmark::State& state)
+	{
+		const auto count = size_t(state.range(0));
+
+		ml::small_pod_vector<uint32_t, 16> vec(32, 1);
+		ml::small_pod_vector<unsigned char> bytes;
+
+		for (auto _ : state)
+		{
+			bytes.clear();
+			for (size_t i = 0; i < count; ++i)
+			{
+				ml::serialize::append(bytes, vec);
+			}
+			benchmark::DoNotOptimize(bytes.data());
+		}
+
+		state.SetBytesProcessed(int64_t(state.iterations() * bytes.size()));
+	}
+}
+
+BENCHMARK(load_views)->Arg(1 << 10)->Arg(1 << 18);
+BENCHMARK(load_copies)->Arg(1 << 10)->Arg(1 << 18);
+BENCHMARK(store)->Arg(1 << 10)->Arg(1 << 18);
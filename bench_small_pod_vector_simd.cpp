@@ -0,0 +1,211 @@
+#include "small_pod_vector_simd.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+	using ml::simd::isa;
+
+	template <typename T>
+	ml::small_pod_vector<T, 16> make_data(size_t n)
+	{
+		ml::small_pod_vector<T, 16> vec;
+		for (size_t i = 0; i < n; ++i)
+		{
+			vec.push_back(T(i % 101));
+		}
+		return vec;
+	}
+
+	// skips the benchmark when the cpu doesn't support Level
+	template <isa Level>
+	bool use_isa(benchmark::State& state)
+	{
+		if (ml::simd::set_isa(Level) != Level)
+		{
+			state.SkipWithError("instruction set not supported");
+			return false;
+		}
+		return true;
+	}
+
+	// the value searched for is absent, so the whole vector is scanned
+
+	template <typename T, isa Level>
+	void simd_find(benchmark::State& state)
+	{
+		if (!use_isa<Level>(state)) return;
+
+		const auto vec = make_data<T>(size_t(state.range(0)));
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(ml::simd::find(vec.data(), vec.size(), T(127)));
+		}
+		state.SetBytesProcessed(int64_t(state.iterations() * vec.byte_size()));
+	}
+
+	template <typename T>
+	void std_find(benchmark::State& state)
+	{
+		const auto vec = make_data<T>(size_t(state.range(0)));
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(std::find(vec.begin(), vec.end(), T(127)));
+		}
+		state.SetBytesProcessed(int64_t(state.iterations() * vec.byte_size()));
+	}
+
+	template <typename T, isa Level>
+	void simd_count(benchmark::State& state)
+	{
+		if (!use_isa<Level>(state)) return;
+
+		const auto vec = make_data<T>(size_t(state.range(0)));
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(ml::simd::count(vec, T(7)));
+		}
+		state.SetBytesProcessed(int64_t(state.iterations() * vec.byte_size()));
+	}
+
+	template <typename T>
+	void std_count(benchmark::State& state)
+	{
+		const auto vec = make_data<T>(size_t(state.range(0)));
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(std::count(vec.begin(), vec.end(), T(7)));
+		}
+		state.SetBytesProcessed(int64_t(state.iterations() * vec.byte_size()));
+	}
+
+	template <typename T, isa Level>
+	void simd_min_max(benchmark::State& state)
+	{
+		if (!use_isa<Level>(state)) return;
+
+		const auto vec = make_data<T>(size_t(state.range(0)));
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(ml::simd::min_value(vec));
+			benchmark::DoNotOptimize(ml::simd::max_value(vec));
+		}
+		state.SetBytesProcessed(int64_t(state.iterations() * vec.byte_size()));
+	}
+
+	template <typename T>
+	void std_min_max(benchmark::State& state)
+	{
+		const auto vec = make_data<T>(size_t(state.range(0)));
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(std::minmax_element(vec.begin(), vec.end()));
+		}
+		state.SetBytesProcessed(int64_t(state.iterations() * vec.byte_size()));
+	}
+
+	template <typename T, isa Level>
+	void simd_sum(benchmark::State& state)
+	{
+		if (!use_isa<Level>(state)) return;
+
+		const auto vec = make_data<T>(size_t(state.range(0)));
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(ml::simd::sum(vec));
+		}
+		state.SetBytesProcessed(int64_t(state.iterations() * vec.byte_size()));
+	}
+
+	template <typename T>
+	void std_sum(benchmark::State& state)
+	{
+		const auto vec = make_data<T>(size_t(state.range(0)));
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(std::accumulate(vec.begin(), vec.end(), ml::simd::sum_type<T>(0)));
+		}
+		state.SetBytesProcessed(int64_t(state.iterations() * vec.byte_size()));
+	}
+
+	template <typename T, isa Level>
+	void simd_equal(benchmark::State& state)
+	{
+		if (!use_isa<Level>(state)) return;
+
+		const auto a = make_data<T>(size_t(state.range(0)));
+		const auto b = a;
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(ml::simd::equal(a, b));
+		}
+		state.SetBytesProcessed(int64_t(state.iterations() * a.byte_size()));
+	}
+
+	template <typename T>
+	void std_equal(benchmark::State& state)
+	{
+		const auto a = make_data<T>(size_t(state.range(0)));
+		const auto b = a;
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin()));
+		}
+		state.SetBytesProcessed(int64_t(state.iterations() * a.byte_size()));
+	}
+
+	// removes about half the elements, on a fresh copy every iteration (the copy is in the timing of both)
+
+	template <typename T, isa Level>
+	void simd_erase_if(benchmark::State& state)
+	{
+		if (!use_isa<Level>(state)) return;
+
+		const auto vec = make_data<T>(size_t(state.range(0)));
+		for (auto _ : state)
+		{
+			auto copy = vec;
+			benchmark::DoNotOptimize(ml::simd::erase_if(copy, ml::simd::compare::less, T(50)));
+		}
+		state.SetBytesProcessed(int64_t(state.iterations() * vec.byte_size()));
+	}
+
+	template <typename T>
+	void std_erase_if(benchmark::State& state)
+	{
+		const auto vec = make_data<T>(size_t(state.range(0)));
+		for (auto _ : state)
+		{
+			auto copy = vec;
+			copy.erase(std::remove_if(copy.begin(), copy.end(), [](T v) { return v < T(50); }), copy.end());
+			benchmark::DoNotOptimize(copy.data());
+		}
+		state.SetBytesProcessed(int64_t(state.iterations() * vec.byte_size()));
+	}
+}
+
+// each kernel per element type and instruction set, against the std algorithm on the same data
+
+#define ML_SPV_BENCH_KERNEL(NAME, T) \
+	BENCHMARK_TEMPLATE(std_##NAME, T)->Arg(16)->Arg(256)->Arg(4096)->Arg(1 << 16); \
+	BENCHMARK_TEMPLATE(simd_##NAME, T, isa::scalar)->Arg(16)->Arg(256)->Arg(4096)->Arg(1 << 16); \
+	BENCHMARK_TEMPLATE(simd_##NAME, T, isa::sse2)->Arg(16)->Arg(256)->Arg(4096)->Arg(1 << 16); \
+	BENCHMARK_TEMPLATE(simd_##NAME, T, isa::avx2)->Arg(16)->Arg(256)->Arg(4096)->Arg(1 << 16); \
+	BENCHMARK_TEMPLATE(simd_##NAME, T, isa::avx512)->Arg(16)->Arg(256)->Arg(4096)->Arg(1 << 16);
+
+#define ML_SPV_BENCH_TYPE(T) \
+	ML_SPV_BENCH_KERNEL(find, T) \
+	ML_SPV_BENCH_KERNEL(count, T) \
+	ML_SPV_BENCH_KERNEL(min_max, T) \
+	ML_SPV_BENCH_KERNEL(sum, T) \
+	ML_SPV_BENCH_KERNEL(equal, T) \
+	ML_SPV_BENCH_KERNEL(erase_if, T)
+
+ML_SPV_BENCH_TYPE(int32_t)
+ML_SPV_BENCH_TYPE(int64_t)
+ML_SPV_BENCH_TYPE(uint8_t)
+ML_SPV_BENCH_TYPE(float)
+ML_SPV_BENCH_TYPE(double)
@@ -0,0 +1,98 @@
+#include "small_pod_vector_uring.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <vector>
+
+#ifdef ML_SPV_HAS_URING
+
+namespace
+{
+	// a 64MB file in the page cache, ingested in chunks of range(0) bytes
+	const size_t file_size = size_t(64) << 20;
+
+	struct test_file
+	{
+		test_file()
+		{
+			f = std::tmpfile();
+			std::vector<char> block(1 << 20, 'x');
+			for (size_t i = 0; i < file_size; i += block.size())
+			{
+				if (::pwrite(fileno(f), block.data(), block.size(), off_t(i)) != ssize_t(block.size())) std::abort();
+			}
+		}
+
+		~test_file()
+		{
+			std::fclose(f);
+		}
+
+		int fd() const { return fileno(f); }
+
+		std::FILE* f;
+	};
+
+	test_file& get_file()
+	{
+		static test_file f;
+		return f;
+	}
+
+	// one blocking pread per chunk
+	void ingest_pread(benchmark::State& state)
+	{
+		const auto chunk = size_t(state.range(0));
+		const auto fd = get_file().fd();
+
+		std::vector<ml::small_pod_vector<char, 64>> chunks(file_size / chunk);
+
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < chunks.size(); ++i)
+			{
+				chunks[i].clear();
+				ml::io::pread_append(fd, chunks[i], chunk, off_t(i * chunk));
+			}
+			benchmark::DoNotOptimize(chunks.data());
+		}
+
+		state.SetBytesProcessed(int64_t(state.iterations() * file_size));
+	}
+
+	// the same chunks through the ring, range(1) reads in flight
+	void ingest_uring(benchmark::State& state)
+	{
+		const auto chunk = size_t(state.range(0));
+		const auto depth = unsigned(state.range(1));
+		const auto fd = get_file().fd();
+
+		ml::uring::ring ring(depth);
+		if (!ring.valid())
+		{
+			state.SkipWithError("io_uring unavailable");
+			return;
+		}
+
+		std::vector<ml::small_pod_vector<char, 64>> chunks(file_size / chunk);
+
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < chunks.size(); ++i)
+			{
+				chunks[i].clear();
+				ring.read_append(fd, chunks[i], chunk, off_t(i * chunk), [](ssize_t) {});
+			}
+			ring.drain();
+			benchmark::DoNotOptimize(chunks.data());
+		}
+
+		state.SetBytesProcessed(int64_t(state.iterations() * file_size));
+	}
+}
+
+BENCHMARK(ingest_pread)->Arg(4096)->Arg(64 << 10)->Arg(1 << 20)->UseRealTime();
+BENCHMARK(ingest_uring)->ArgsProduct({ { 4096, 64 << 10, 1 << 20 }, { 8, 64 } })->UseRealTime();
+
+#endif
@@ -1,24 +1,158 @@
 
-// ml-small_pod_vector v1.00
+// ml-small_pod_vector v1.15
 
 
 //                  VERSION HISTORY
 //
 //  1.00 Initial version
 //  1.01 implemented resize()
+//  1.02 optional realloc / try_expand_in_place allocator hooks used when growing
+//  1.03 optional sized free and allocate_at_least allocator hooks
+//  1.04 GrowthPolicy template parameter
+//  1.05 Layout template parameter (pointers, compact), empty allocators take no space
+//  1.06 inline_union layout (SSO style), sso_pod_vector
+//  1.07 RetentionPolicy template parameter, release_spare() and trim()
+//  1.08 emplace_back, push_back_unchecked, push_back fast path
+//  1.09 resize_uninitialized, append_uninitialized, resize_and_overwrite, resize(n, value)
+//  1.10 bulk fill (memset for uniform bytes), append_fill, insert(pos, n, value)
+//  1.11 growth copies only the live elements, around the hole when inserting. ML_SPV_COUNT_COPIES
+//  1.12 StatsPolicy template parameter (stats::counting in small_pod_vector_stats.hpp)
+//  1.13 pinned buffers (impl::pin) asserted not to move or go away, ML_SPV_CHECK_PINS
+//  1.14 insert_many, erase_many
+//  1.15 reserve_writable, commit_uninitialized
 
 #pragma once
 
 #include <type_traits>
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
 #include <memory>
+#include <new>
+#include <utility>
 #include <assert.h>
 
+// keeps rarely taken paths out of the callers
+#if defined(__GNUC__)
+#define ML_SPV_NOINLINE __attribute__((noinline, cold))
+#define ML_SPV_LIKELY(x) __builtin_expect(!!(x), 1)
+#elif defined(_MSC_VER)
+#define ML_SPV_NOINLINE __declspec(noinline)
+#define ML_SPV_LIKELY(x) (x)
+#else
+#define ML_SPV_NOINLINE
+#define ML_SPV_LIKELY(x) (x)
+#endif
+
+// define ML_SPV_COUNT_COPIES to count the bytes growing, inserting and erasing move around in ml::impl::bytes_copied()
+#ifdef ML_SPV_COUNT_COPIES
+#define ML_SPV_COPIED(bytes) (ml::impl::bytes_copied() += (bytes))
+#else
+#define ML_SPV_COPIED(bytes) ((void)0)
+#endif
+
+// buffers pinned with ml::impl::pin (I/O in flight) are asserted not to move or be freed. on in debug builds
+#ifndef ML_SPV_CHECK_PINS
+#ifdef NDEBUG
+#define ML_SPV_CHECK_PINS 0
+#else
+#define ML_SPV_CHECK_PINS 1
+#endif
+#endif
+
+#if ML_SPV_CHECK_PINS
+#include <atomic>
+#endif
+
 namespace ml
 {
 
 	namespace impl
 	{
+#ifdef ML_SPV_COUNT_COPIES
+		// per thread, includes what an allocator's realloc copies when it moves a block
+		inline size_t& bytes_copied()
+		{
+			static thread_local size_t bytes = 0;
+			return bytes;
+		}
+#endif
+
+#if ML_SPV_CHECK_PINS
+		// the pinned buffers, one slot per pin. only looked through while something is pinned
+		struct pin_table
+		{
+			static constexpr size_t slots = 1024;
+
+			std::atomic<size_t> pinned{ 0 };
+			std::atomic<const void*> buffers[slots];
+		};
+
+		inline pin_table& get_pin_table()
+		{
+			// trivially destructible, pins may outlive static destruction
+			static pin_table t;
+			return t;
+		}
+
+		inline void pin(const void* buffer)
+		{
+			auto& t = get_pin_table();
+			for (auto& slot : t.buffers)
+			{
+				const void* expected = nullptr;
+				if (slot.compare_exchange_strong(expected, buffer))
+				{
+					t.pinned.fetch_add(1);
+					return;
+				}
+			}
+			assert(!"ml::impl::pin: too many pinned buffers");
+		}
+
+		inline void unpin(const void* buffer)
+		{
+			auto& t = get_pin_table();
+			for (auto& slot : t.buffers)
+			{
+				const void* expected = buffer;
+				if (slot.compare_exchange_strong(expected, nullptr))
+				{
+					t.pinned.fetch_sub(1);
+					return;
+				}
+			}
+			assert(!"ml::impl::unpin: the buffer isn't pinned");
+		}
+
+		inline bool is_pinned(const void* buffer)
+		{
+			auto& t = get_pin_table();
+			if (t.pinned.load(std::memory_order_relaxed) == 0) return false;
+
+			for (auto& slot : t.buffers)
+			{
+				if (slot.load() == buffer) return true;
+			}
+			return false;
+		}
+#else
+		inline void pin(const void*) {}
+		inline void unpin(const void*) {}
+		inline bool is_pinned(const void*) { return false; }
+#endif
+
+		// the block returned by allocate_at_least, size may be larger than requested
+		struct allocation_result
+		{
+			void* ptr;
+			size_t size;
+		};
+
 		class pod_allocator
 		{
 		public:
@@ -26,19 +160,596 @@ namespace ml
 			static void* malloc(size_type size) { return std::malloc(size); }
 			static void free(void* mem) { std::free(mem); }
 
+			// optional: resize a block, keeping its contents. may move it
+			static void* realloc(void* mem, size_type /*old_size*/, size_type new_size) { return std::realloc(mem, new_size); }
+
+		};
+
+		// Alloc concept:
+		//	size_type
+		//	void* malloc(size_type size)								(or allocate_at_least)
+		//	void free(void* mem)										(or the sized free)
+		// optional:
+		//	void* realloc(void* mem, size_type old_size, size_type new_size)
+		//	bool try_expand_in_place(void* mem, size_type old_size, size_type new_size)
+		//	allocation_result allocate_at_least(size_type size)		the real size of the block is used as capacity
+		//	void free(void* mem, size_type size)						size is between the requested and the real size
+
+		template<typename A, typename = void>
+		struct has_realloc : std::false_type {};
+
+		template<typename A>
+		struct has_realloc<A, decltype(void(std::declval<A&>().realloc(std::declval<void*>(), size_t(), size_t())))> : std::true_type {};
+
+		template<typename A, typename = void>
+		struct has_try_expand_in_place : std::false_type {};
+
+		template<typename A>
+		struct has_try_expand_in_place<A, decltype(void(std::declval<A&>().try_expand_in_place(std::declval<void*>(), size_t(), size_t())))> : std::true_type {};
+
+		template<typename A, typename = void>
+		struct has_allocate_at_least : std::false_type {};
+
+		template<typename A>
+		struct has_allocate_at_least<A, decltype(void(std::declval<A&>().allocate_at_least(size_t()).ptr))> : std::true_type {};
+
+		template<typename A, typename = void>
+		struct has_sized_free : std::false_type {};
+
+		template<typename A>
+		struct has_sized_free<A, decltype(void(std::declval<A&>().free(std::declval<void*>(), size_t())))> : std::true_type {};
+
+		template<typename Alloc>
+		struct alloc_traits
+		{
+			static allocation_result allocate(Alloc& a, size_t size)
+			{
+				return allocate(a, size, has_allocate_at_least<Alloc>());
+			}
+
+			static void deallocate(Alloc& a, void* mem, size_t size)
+			{
+				deallocate(a, mem, size, has_sized_free<Alloc>());
+			}
+
+			// resize the block mem of old_size bytes to new_size bytes, of which the first used bytes are alive
+			// returns the (potentially new) block
+			static allocation_result reallocate(Alloc& a, void* mem, size_t old_size, size_t new_size, size_t used)
+			{
+				return reallocate(a, mem, old_size, new_size, used, used, 0);
+			}
+
+			// as above, but the live bytes from offset on end up gap bytes further
+			static allocation_result reallocate(Alloc& a, void* mem, size_t old_size, size_t new_size, size_t used, size_t offset, size_t gap)
+			{
+				assert(used <= old_size && offset <= used && used + gap <= new_size);
+
+				if (new_size > old_size && try_expand_in_place(a, mem, old_size, new_size, has_try_expand_in_place<Alloc>()))
+				{
+					open_gap(mem, used, offset, gap);
+					return { mem, new_size };
+				}
+
+				// a moving realloc copies the whole old block, dead tail included, and the gap costs another pass.
+				// it's only worth it when shrinking (usually in place) or when most of the block is alive and nothing shifts
+				if (new_size <= old_size || (offset == used && used >= old_size / 2))
+				{
+					return realloc(a, mem, old_size, new_size, used, has_realloc<Alloc>());
+				}
+
+				return relocate(a, mem, old_size, new_size, used, offset, gap);
+			}
+
+		private:
+			static allocation_result allocate(Alloc& a, size_t size, std::true_type)
+			{
+				auto result = a.allocate_at_least(size);
+				assert(result.size >= size);
+				return { result.ptr, result.size };
+			}
+
+			static allocation_result allocate(Alloc& a, size_t size, std::false_type)
+			{
+				return { a.malloc(size), size };
+			}
+
+			static void deallocate(Alloc& a, void* mem, size_t size, std::true_type)
+			{
+				a.free(mem, size);
+			}
+
+			static void deallocate(Alloc& a, void* mem, size_t, std::false_type)
+			{
+				a.free(mem);
+			}
+
+			static bool try_expand_in_place(Alloc& a, void* mem, size_t old_size, size_t new_size, std::true_type)
+			{
+				return a.try_expand_in_place(mem, old_size, new_size);
+			}
+
+			static bool try_expand_in_place(Alloc&, void*, size_t, size_t, std::false_type)
+			{
+				return false;
+			}
+
+			static allocation_result realloc(Alloc& a, void* mem, size_t old_size, size_t new_size, size_t, std::true_type)
+			{
+				auto ptr = a.realloc(mem, old_size, new_size);
+				if (ptr != mem)
+				{
+					ML_SPV_COPIED(old_size < new_size ? old_size : new_size);
+				}
+				return { ptr, new_size };
+			}
+
+			static allocation_result realloc(Alloc& a, void* mem, size_t old_size, size_t new_size, size_t used, std::false_type)
+			{
+				return relocate(a, mem, old_size, new_size, used, used, 0);
+			}
+
+			// a new block, the live bytes copied once in two segments around the gap
+			static allocation_result relocate(Alloc& a, void* mem, size_t old_size, size_t new_size, size_t used, size_t offset, size_t gap)
+			{
+				auto result = allocate(a, new_size);
+				auto from = static_cast<const unsigned char*>(mem);
+				auto to = static_cast<unsigned char*>(result.ptr);
+				std::memcpy(to, from, offset);
+				std::memcpy(to + offset + gap, from + offset, used - offset);
+				ML_SPV_COPIED(used);
+				deallocate(a, mem, old_size);
+				return result;
+			}
+
+			static void open_gap(void* mem, size_t used, size_t offset, size_t gap)
+			{
+				auto p = static_cast<unsigned char*>(mem);
+				std::memmove(p + offset + gap, p + offset, used - offset);
+				ML_SPV_COPIED(used - offset);
+			}
+		};
+	}
+
+	// GrowthPolicy concept:
+	//	static size_t spill_capacity(size_t static_capacity, size_t required, size_t value_size)	capacity when leaving the static buffer
+	//	static size_t grow_capacity(size_t capacity, size_t required, size_t value_size)			capacity when the dynamic buffer is full
+	// both return at least required
+	namespace growth
+	{
+		// spill to exactly what's needed plus 4, then double (the original behaviour)
+		struct tight_spill
+		{
+			static size_t spill_capacity(size_t, size_t required, size_t) { return required + 4; }
+
+			static size_t grow_capacity(size_t capacity, size_t required, size_t)
+			{
+				while (capacity < required)
+				{
+					capacity *= 2;
+				}
+				return capacity;
+			}
+		};
+
+		struct doubling
+		{
+			static size_t spill_capacity(size_t static_capacity, size_t required, size_t) { return grow(static_capacity, required); }
+			static size_t grow_capacity(size_t capacity, size_t required, size_t) { return grow(capacity, required); }
+
+		private:
+			static size_t grow(size_t capacity, size_t required) { return capacity * 2 > required ? capacity * 2 : required; }
+		};
+
+		struct one_and_a_half
+		{
+			static size_t spill_capacity(size_t static_capacity, size_t required, size_t) { return grow(static_capacity, required); }
+			static size_t grow_capacity(size_t capacity, size_t required, size_t) { return grow(capacity, required); }
+
+		private:
+			static size_t grow(size_t capacity, size_t required) { return capacity + capacity / 2 > required ? capacity + capacity / 2 : required; }
+		};
+
+		// rounds the byte size chosen by Base up to whole pages
+		template<size_t PageSize = 4096, class Base = doubling>
+		struct page_rounded
+		{
+			static size_t spill_capacity(size_t static_capacity, size_t required, size_t value_size) { return round(Base::spill_capacity(static_capacity, required, value_size), value_size); }
+			static size_t grow_capacity(size_t capacity, size_t required, size_t value_size) { return round(Base::grow_capacity(capacity, required, value_size), value_size); }
+
+		private:
+			static size_t round(size_t capacity, size_t value_size)
+			{
+				const auto bytes = (capacity * value_size + PageSize - 1) / PageSize * PageSize;
+				return bytes / value_size;
+			}
+		};
+
+		// grows in steps of Chunk elements
+		template<size_t Chunk>
+		struct fixed_chunk
+		{
+			static_assert(Chunk > 0, "ml::growth::fixed_chunk: chunk must not be empty");
+
+			static size_t spill_capacity(size_t, size_t required, size_t) { return round(required); }
+			static size_t grow_capacity(size_t, size_t required, size_t) { return round(required); }
+
+		private:
+			static size_t round(size_t required) { return (required + Chunk - 1) / Chunk * Chunk; }
+		};
+	}
+
+	// RetentionPolicy concept:
+	//	static bool retain(size_t bytes)	whether a dynamic buffer of bytes is kept when reverting to the static buffer
+	// a kept buffer is reused when spilling again, but it's held until then
+	namespace retention
+	{
+		// keep the buffer whatever its size (the original behaviour)
+		struct keep
+		{
+			static bool retain(size_t) { return true; }
+		};
+
+		// keep buffers up to Bytes, release larger ones
+		template<size_t Bytes>
+		struct keep_below
+		{
+			static bool retain(size_t bytes) { return bytes <= Bytes; }
+		};
+
+		// always free the buffer
+		struct release
+		{
+			static bool retain(size_t) { return false; }
 		};
 	}
 
-	template<typename T, size_t StaticCapacity = 16, size_t RevertToStaticSize = 0, class Alloc = impl::pod_allocator>
-	class small_pod_vector
+	// StatsPolicy concept: every vector holds one (an empty one takes no space) and calls
+	//	void on_allocate(size_t bytes)								a dynamic buffer was allocated
+	//	void on_free(size_t bytes)									one was freed
+	//	void on_reallocate(size_t old_bytes, size_t new_bytes, size_t copied)	the dynamic buffer was resized, copied bytes moved
+	//	void on_spill(size_t copied)								the elements moved from the static buffer to a dynamic one
+	//	void on_revert(size_t copied)								and back
+	//	void on_size(size_t size)									the size may have grown
+	//	void on_move_from(StatsPolicy& other)						the elements of another vector were taken over
+	namespace stats
+	{
+		// records nothing (the default)
+		struct none
+		{
+			void on_allocate(size_t) {}
+			void on_free(size_t) {}
+			void on_reallocate(size_t, size_t, size_t) {}
+			void on_spill(size_t) {}
+			void on_revert(size_t) {}
+			void on_size(size_t) {}
+			void on_move_from(none&) {}
+		};
+	}
+
+	// Layout concept: a type with a nested
+	//	template<typename T, size_t StaticCapacity> class storage
+	// holding the static buffer, the dynamic buffer and the size, see layout::pointers
+	// a layout that retains_dynamic keeps the dynamic buffer around while the static one is in use
+	namespace layout
+	{
+		// begin, end and capacity are stored, so element access, size() and capacity() don't branch
+		struct pointers
+		{
+			template<typename T, size_t StaticCapacity>
+			class storage
+			{
+			public:
+				static constexpr bool retains_dynamic = true;
+				static constexpr size_t max_size = size_t(-1) / sizeof(T);
+
+				storage()
+					: m_begin(static_ptr())
+					, m_end(m_begin)
+					, m_capacity(StaticCapacity)
+					, m_dynamic_capacity(0)
+					, m_dynamic_data(nullptr)
+				{}
+
+				storage(const storage&) = delete;
+				storage& operator=(const storage&) = delete;
+
+				T* begin_ptr() const { return m_begin; }
+				T* end_ptr() const { return m_end; }
+				size_t size() const { return size_t(m_end - m_begin); }
+				size_t capacity() const { return m_capacity; }
+				bool is_static() const { return m_begin == static_ptr(); }
+
+				T* static_ptr() const { return const_cast<T*>(reinterpret_cast<const T*>(m_static_data + 0)); }
+				T* dynamic_ptr() const { return m_dynamic_data; }
+				size_t dynamic_capacity() const { return m_dynamic_capacity; }
+
+				// replace the dynamic buffer, if it's in use the elements are expected to have moved along
+				void set_dynamic(T* data, size_t capacity)
+				{
+					if (!is_static())
+					{
+						const auto s = size();
+						m_begin = data;
+						m_end = data + s;
+						m_capacity = capacity;
+					}
+
+					m_dynamic_data = data;
+					m_dynamic_capacity = capacity;
+				}
+
+				void use_static(size_t size)
+				{
+					m_begin = static_ptr();
+					m_end = m_begin + size;
+					m_capacity = StaticCapacity;
+				}
+
+				void use_dynamic(T* data, size_t capacity, size_t size)
+				{
+					m_dynamic_data = data;
+					m_dynamic_capacity = capacity;
+					m_begin = data;
+					m_end = m_begin + size;
+					m_capacity = capacity;
+				}
+
+				void set_size(size_t size)
+				{
+					m_end = m_begin + size;
+				}
+
+			private:
+				T* m_begin;
+				T* m_end;
+				size_t m_capacity;
+				size_t m_dynamic_capacity;
+				T* m_dynamic_data;
+				typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type m_static_data[StaticCapacity];
+			};
+		};
+
+		// only the dynamic pointer, the size and the dynamic capacity are stored, the size as SizeType
+		// with the lowest bit telling whether the dynamic buffer is in use
+		// begin() and capacity() cost a branch, in exchange the header is 16 bytes with 32-bit sizes
+		template<typename SizeType = uint32_t>
+		struct compact
+		{
+			static_assert(std::is_unsigned<SizeType>::value, "ml::layout::compact: the size type must be unsigned");
+
+			template<typename T, size_t StaticCapacity>
+			class storage
+			{
+			public:
+				static constexpr bool retains_dynamic = true;
+				static constexpr size_t max_size = size_t(SizeType(-1) >> 1) < size_t(-1) / sizeof(T) ? size_t(SizeType(-1) >> 1) : size_t(-1) / sizeof(T);
+
+				static_assert(StaticCapacity <= max_size, "ml::layout::compact: the static capacity doesn't fit the size type");
+
+				storage()
+					: m_dynamic_data(nullptr)
+					, m_size(0)
+					, m_dynamic_capacity(0)
+				{}
+
+				storage(const storage&) = delete;
+				storage& operator=(const storage&) = delete;
+
+				T* begin_ptr() const { return is_static() ? static_ptr() : m_dynamic_data; }
+				T* end_ptr() const { return begin_ptr() + size(); }
+				size_t size() const { return size_t(m_size >> 1); }
+				size_t capacity() const { return is_static() ? StaticCapacity : size_t(m_dynamic_capacity); }
+				bool is_static() const { return (m_size & 1) == 0; }
+
+				T* static_ptr() const { return const_cast<T*>(reinterpret_cast<const T*>(m_static_data + 0)); }
+				T* dynamic_ptr() const { return m_dynamic_data; }
+				size_t dynamic_capacity() const { return size_t(m_dynamic_capacity); }
+
+				void set_dynamic(T* data, size_t capacity)
+				{
+					m_dynamic_data = data;
+					// an allocator may hand back more than we can count
+					m_dynamic_capacity = SizeType(capacity < max_size ? capacity : max_size);
+				}
+
+				void use_static(size_t size)
+				{
+					assert(size <= StaticCapacity);
+					m_size = SizeType(size << 1);
+				}
+
+				void use_dynamic(T* data, size_t capacity, size_t size)
+				{
+					set_dynamic(data, capacity);
+					assert(size <= m_dynamic_capacity);
+					m_size = SizeType(size << 1 | 1);
+				}
+
+				void set_size(size_t size)
+				{
+					assert(size <= max_size);
+					m_size = SizeType(size << 1 | (m_size & 1));
+				}
+
+			private:
+				T* m_dynamic_data;
+				SizeType m_size;
+				SizeType m_dynamic_capacity;
+				typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type m_static_data[StaticCapacity];
+			};
+		};
+
+		// like std::string's short string optimization, the static buffer and the dynamic pointer and
+		// capacity share their bytes. a vector that has spilled doesn't carry a dead static buffer, but it
+		// can't keep its dynamic buffer when going back to the static one either
+		// the size is stored as in compact
+		template<typename SizeType = uint32_t>
+		struct inline_union
+		{
+			static_assert(std::is_unsigned<SizeType>::value, "ml::layout::inline_union: the size type must be unsigned");
+
+			template<typename T, size_t StaticCapacity>
+			class storage
+			{
+			public:
+				static constexpr bool retains_dynamic = false;
+				static constexpr size_t max_size = size_t(SizeType(-1) >> 1) < size_t(-1) / sizeof(T) ? size_t(SizeType(-1) >> 1) : size_t(-1) / sizeof(T);
+
+				static_assert(StaticCapacity <= max_size, "ml::layout::inline_union: the static capacity doesn't fit the size type");
+
+				storage()
+					: m_size(0)
+				{}
+
+				storage(const storage&) = delete;
+				storage& operator=(const storage&) = delete;
+
+				T* begin_ptr() const { return is_static() ? static_ptr() : heap_data(); }
+				T* end_ptr() const { return begin_ptr() + size(); }
+				size_t size() const { return size_t(m_size >> 1); }
+				size_t capacity() const { return is_static() ? StaticCapacity : heap_capacity(); }
+				bool is_static() const { return (m_size & 1) == 0; }
+
+				T* static_ptr() const { return const_cast<T*>(reinterpret_cast<const T*>(m_static_data + 0)); }
+				T* dynamic_ptr() const { return is_static() ? nullptr : heap_data(); }
+				size_t dynamic_capacity() const { return is_static() ? 0 : heap_capacity(); }
+
+				// only while the dynamic buffer is in use, there's no room to keep it otherwise
+				void set_dynamic(T* data, size_t capacity)
+				{
+					assert(!is_static() || !data);
+					if (!is_static())
+					{
+						set_heap(data, capacity);
+					}
+				}
+
+				// the dynamic pointer is overwritten by the elements
+				void use_static(size_t size)
+				{
+					assert(size <= StaticCapacity);
+					m_size = SizeType(size << 1);
+				}
+
+				void use_dynamic(T* data, size_t capacity, size_t size)
+				{
+					set_heap(data, capacity);
+					m_size = SizeType(size << 1 | 1);
+				}
+
+				void set_size(size_t size)
+				{
+					assert(size <= max_size);
+					m_size = SizeType(size << 1 | (m_size & 1));
+				}
+
+			private:
+				// the heap part is kept as bytes so it doesn't raise the alignment above T's
+				T* heap_data() const
+				{
+					T* data;
+					std::memcpy(&data, m_heap, sizeof(data));
+					return data;
+				}
+
+				size_t heap_capacity() const
+				{
+					SizeType capacity;
+					std::memcpy(&capacity, m_heap + sizeof(T*), sizeof(capacity));
+					return size_t(capacity);
+				}
+
+				void set_heap(T* data, size_t capacity)
+				{
+					const auto c = SizeType(capacity < max_size ? capacity : max_size);
+					std::memcpy(m_heap, &data, sizeof(data));
+					std::memcpy(m_heap + sizeof(T*), &c, sizeof(c));
+				}
+
+				SizeType m_size;
+				union
+				{
+					unsigned char m_heap[sizeof(T*) + sizeof(SizeType)];
+					typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type m_static_data[StaticCapacity];
+				};
+			};
+
+			// the largest static capacity that keeps the storage within TargetSize bytes
+			template<typename T, size_t TargetSize>
+			struct capacity_for
+			{
+				static constexpr size_t header = (sizeof(SizeType) + alignof(T) - 1) / alignof(T) * alignof(T);
+				static constexpr size_t value = TargetSize > header ? (TargetSize - header) / sizeof(T) : 0;
+
+				static_assert(value * sizeof(T) >= sizeof(T*) + sizeof(SizeType), "ml::layout::inline_union: the target size can't hold the dynamic pointer and capacity");
+			};
+		};
+	}
+
+	namespace impl
+	{
+		// keeps an empty allocator from taking up space
+		template<typename Alloc, bool = std::is_empty<Alloc>::value && !std::is_final<Alloc>::value>
+		class alloc_holder : private Alloc
+		{
+		public:
+			alloc_holder(Alloc alloc)
+				: Alloc(std::move(alloc))
+			{}
+
+			Alloc& get_alloc() { return *this; }
+			const Alloc& get_alloc() const { return *this; }
+		};
+
+		template<typename Alloc>
+		class alloc_holder<Alloc, false>
+		{
+		public:
+			alloc_holder(Alloc alloc)
+				: m_alloc(std::move(alloc))
+			{}
+
+			Alloc& get_alloc() { return m_alloc; }
+			const Alloc& get_alloc() const { return m_alloc; }
+
+		private:
+			Alloc m_alloc;
+		};
+
+		// keeps an empty stats policy from taking up space
+		template<typename Stats, bool = std::is_empty<Stats>::value && !std::is_final<Stats>::value>
+		class stats_holder : private Stats
+		{
+		public:
+			Stats& get_stats() { return *this; }
+		};
+
+		template<typename Stats>
+		class stats_holder<Stats, false>
+		{
+		public:
+			Stats& get_stats() { return m_stats; }
+
+		private:
+			Stats m_stats;
+		};
+	}
+
+	template<typename T, size_t StaticCapacity = 16, size_t RevertToStaticSize = 0, class Alloc = impl::pod_allocator, class GrowthPolicy = growth::tight_spill, class Layout = layout::pointers, class RetentionPolicy = retention::keep, class StatsPolicy = stats::none>
+	class small_pod_vector : private impl::alloc_holder<Alloc>, private impl::stats_holder<StatsPolicy>
 	{
 		static_assert(RevertToStaticSize <= StaticCapacity + 1, "ml::small_pod_vector: the revert-to-static size shouldn't exceed the static capacity by more than one");
 
 		static_assert(std::is_trivial<T>::value, "ml::small_pod_vector with non-trivial type");
 
+		using storage_type = typename Layout::template storage<T, StaticCapacity>;
 
 	public:
 		using allocator_type = Alloc;
+		using growth_policy = GrowthPolicy;
+		using layout_type = Layout;
+		using retention_policy = RetentionPolicy;
+		using stats_policy = StatsPolicy;
 		using value_type = T;
 		using size_type = typename Alloc::size_type;
 		using reference = T & ;
@@ -59,13 +770,8 @@ namespace ml
 		{}
 
 		small_pod_vector(const Alloc& alloc)
-			: m_alloc(alloc)
-			, m_capacity(StaticCapacity)
-			, m_dynamic_capacity(0)
-			, m_dynamic_data(nullptr)
-		{
-			m_begin = m_end = static_begin_ptr();
-		}
+			: impl::alloc_holder<Alloc>(alloc)
+		{}
 
 		explicit small_pod_vector(size_t count, const Alloc& alloc = Alloc())
 			: small_pod_vector(alloc)
@@ -99,58 +805,37 @@ namespace ml
 		small_pod_vector(const small_pod_vector& v, const Alloc& alloc)
 			: small_pod_vector(alloc)
 		{
-			if (v.size() > StaticCapacity)
+			const auto s = v.size();
+
+			if (s > StaticCapacity)
 			{
-				m_dynamic_capacity = v.size();
-				m_begin = m_dynamic_data = pointer(m_alloc.malloc(sizeof(value_type)*m_dynamic_capacity));
-				m_capacity = v.size();
+				// exactly what's needed
+				auto buf = allocate(s);
+				std::memcpy(buf.data, v.data(), v.byte_size());
+				m_storage.use_dynamic(buf.data, buf.capacity, s);
 			}
 			else
 			{
-				m_begin = static_begin_ptr();
-				m_capacity = StaticCapacity;
+				std::memcpy(m_storage.static_ptr(), v.data(), v.byte_size());
+				m_storage.use_static(s);
 			}
 
-			memcpy(m_begin, v.m_begin, v.byte_size());
-
-			m_end = m_begin + v.size();
-
+			get_stats().on_size(s);
 		}
 
 		small_pod_vector(small_pod_vector&& v)
-			: m_alloc(std::move(v.m_alloc))
-			, m_capacity(v.m_capacity)
-			, m_dynamic_capacity(v.m_dynamic_capacity)
-			, m_dynamic_data(v.m_dynamic_data)
+			: impl::alloc_holder<Alloc>(std::move(v.get_alloc()))
 		{
-			if (v.m_begin == v.static_begin_ptr())
-			{
-				m_begin = static_begin_ptr();
-				m_end = m_begin + v.size();
-
-				memcpy(m_begin, v.m_begin, v.byte_size());
-
-				v.clear();
-			}
-			else
-			{
-				m_begin = v.m_begin;
-				m_end = v.m_end;
-			}
-
-			v.m_dynamic_capacity = 0;
-			v.m_dynamic_data = nullptr;
-			v.m_begin = v.m_end = v.static_begin_ptr();
-			v.m_capacity = StaticCapacity;
+			take(v);
 		}
 
 		~small_pod_vector()
 		{
-			clear();
+			assert(!impl::is_pinned(data()));
 
-			if (m_dynamic_data)
+			if (m_storage.dynamic_ptr())
 			{
-				m_alloc.free(m_dynamic_data);
+				deallocate({ m_storage.dynamic_ptr(), m_storage.dynamic_capacity() });
 			}
 		}
 
@@ -161,54 +846,32 @@ namespace ml
 				return *this;
 			}
 
-			clear();
-
-			if (m_begin != static_begin_ptr())
-			{
-				m_begin = static_begin_ptr();
-			}
-
-
-			auto buff = choose_data(v.size());
-
-			memcpy(buff, v.m_begin, v.byte_size());
+			to_static();
 
-			m_begin = buff;
-			m_end = m_begin + v.size();
+			resize(v.size());
 
-			update_capacity();
+			std::memcpy(data(), v.data(), v.byte_size());
 
 			return *this;
 		}
 
 		small_pod_vector& operator=(small_pod_vector&& v)
 		{
-			clear();
-
-			get_alloc() = std::move(v.get_alloc());
-			m_capacity = v.m_capacity;
-			m_dynamic_capacity = v.m_dynamic_capacity;
-			m_dynamic_data = v.m_dynamic_data;
-
-			if (v.m_begin == v.static_begin_ptr())
+			if (this == &v)
 			{
-				m_begin = static_begin_ptr();
-				m_end = m_begin + v.size();
+				return *this;
+			}
 
-				memcpy(m_begin, v.m_begin, v.byte_size());
+			to_static();
 
-				v.clear();
-			}
-			else
+			if (m_storage.dynamic_ptr())
 			{
-				m_begin = v.m_begin;
-				m_end = v.m_end;
+				free_retained();
 			}
 
-			v.m_dynamic_capacity = 0;
-			v.m_dynamic_data = nullptr;
-			v.m_begin = v.m_end = v.static_begin_ptr();
-			v.m_capacity = StaticCapacity;
+			get_alloc() = std::move(v.get_alloc());
+
+			take(v);
 
 			return *this;
 		}
@@ -234,19 +897,19 @@ namespace ml
 
 		allocator_type get_allocator() const
 		{
-			return m_alloc;
+			return get_alloc();
 		}
 
 		const_reference at(size_type i) const
 		{
 			assert(i < size());
-			return *(m_begin + i);
+			return *(begin() + i);
 		}
 
 		reference at(size_type i)
 		{
 			assert(i < size());
-			return *(m_begin + i);
+			return *(begin() + i);
 		}
 
 		const_reference operator[](size_type i) const
@@ -271,53 +934,53 @@ namespace ml
 
 		const_reference back() const
 		{
-			return *(m_end - 1);
+			return *(end() - 1);
 		}
 
 		reference back()
 		{
-			return *(m_end - 1);
+			return *(end() - 1);
 		}
 
 		const_pointer data() const noexcept
 		{
-			return m_begin;
+			return m_storage.begin_ptr();
 		}
 
 		pointer data() noexcept
 		{
-			return m_begin;
+			return m_storage.begin_ptr();
 		}
 
 		// iterators
 		iterator begin() noexcept
 		{
-			return m_begin;
+			return m_storage.begin_ptr();
 		}
 
 		const_iterator begin() const noexcept
 		{
-			return m_begin;
+			return m_storage.begin_ptr();
 		}
 
 		const_iterator cbegin() const noexcept
 		{
-			return m_begin;
+			return m_storage.begin_ptr();
 		}
 
 		iterator end() noexcept
 		{
-			return m_end;
+			return m_storage.end_ptr();
 		}
 
 		const_iterator end() const noexcept
 		{
-			return m_end;
+			return m_storage.end_ptr();
 		}
 
 		const_iterator cend() const noexcept
 		{
-			return m_end;
+			return m_storage.end_ptr();
 		}
 
 		reverse_iterator rbegin() noexcept
@@ -352,12 +1015,17 @@ namespace ml
 
 		bool empty() const noexcept
 		{
-			return m_begin == m_end;
+			return size() == 0;
 		}
 
 		size_t size() const noexcept
 		{
-			return m_end - m_begin;
+			return m_storage.size();
+		}
+
+		static constexpr size_t max_size() noexcept
+		{
+			return storage_type::max_size;
 		}
 
 		size_t byte_size() const noexcept
@@ -367,94 +1035,117 @@ namespace ml
 
 		void reserve(size_type new_cap)
 		{
-			if (new_cap <= m_capacity) return;
+			if (new_cap <= capacity()) return;
 
 			auto new_buf = choose_data(new_cap);
 
-			assert(new_buf != m_begin); // should've been handled by new_cap <= m_capacity
-			assert(new_buf != static_begin_ptr()); // we should never reserve into static memory
+			if (new_buf.data == data())
+			{
+				// the dynamic buffer was grown (in place or moved by the allocator)
+				return;
+			}
+
+			assert(new_buf.data != m_storage.static_ptr()); // we should never reserve into static memory
 
 			const auto s = size();
-			if (s < RevertToStaticSize)
+			if (s < RevertToStaticSize && retain(new_buf.capacity))
 			{
 				// we've allocated enough memory for the dynamic buffer but don't move there until we have to
+				m_storage.set_dynamic(new_buf.data, new_buf.capacity);
 				return;
 			}
 
-			memcpy(new_buf, m_begin, m_capacity * sizeof(value_type));
+			move_to(new_buf, s, 0, 0);
+		}
+
+		// like reserve(), but capacity() is at least new_cap afterwards, below RevertToStaticSize too
+		// (the elements move to the dynamic buffer now), for writing past size() before growing into it
+		void reserve_writable(size_type new_cap)
+		{
+			reserve(new_cap);
+
+			if (new_cap <= capacity()) return;
 
-			if (m_begin != static_begin_ptr())
-			{
-				assert(m_begin != m_dynamic_data);
-				m_alloc.free(m_begin);
-			}
+			// reserve() only recorded the dynamic buffer
+			assert(m_storage.is_static() && m_storage.dynamic_capacity() >= new_cap);
+			move_to({ m_storage.dynamic_ptr(), m_storage.dynamic_capacity() }, size(), 0, 0);
+		}
+
+		// grows by the n elements already written past size(), in place. unlike resize_uninitialized()
+		// this never reverts to the static buffer, which would leave the written elements behind
+		void commit_uninitialized(size_type n)
+		{
+			const auto s = size();
+			assert(s + n <= capacity());
 
-			m_begin = new_buf;
-			m_end = new_buf + s;
-			m_capacity = m_dynamic_capacity;
+			m_storage.set_size(s + n);
+			get_stats().on_size(s + n);
 		}
 
-		constexpr size_t capacity() const noexcept
+		size_t capacity() const noexcept
 		{
-			return m_capacity;
+			return m_storage.capacity();
 		}
 
 		void shrink_to_fit()
 		{
 			const auto s = size();
 
-			if (s == m_capacity) return;
-			if (m_begin == static_begin_ptr()) return;
+			if (s == capacity()) return;
+			if (m_storage.is_static()) return;
 
 
 			if (s < StaticCapacity)
 			{
 				// revert to static capacity
-				m_begin = static_begin_ptr();
-
-				m_capacity = StaticCapacity;
-
-				memcpy(m_begin, m_dynamic_data, m_capacity * sizeof(value_type));
-
-				m_end = m_begin + s;
+				move_to({ m_storage.static_ptr(), StaticCapacity }, s, 0, 0);
 
 				//deallocate memory. 				
-				m_alloc.free(m_dynamic_data);
-				m_dynamic_data = nullptr;
-				m_dynamic_capacity = 0;
+				if (m_storage.dynamic_ptr())
+				{
+					free_retained();
+				}
 			}
 			else
 			{
-				// alloc new smaller buffer
-
-				auto new_buf = pointer(m_alloc.malloc(sizeof(value_type)*s));
+				// shrink the buffer, in place if the allocator can
+				assert(!impl::is_pinned(data()));
 
-				m_capacity = s;
+				auto result = impl::alloc_traits<Alloc>::reallocate(get_alloc(), data(), sizeof(value_type)*m_storage.dynamic_capacity(), sizeof(value_type)*s, byte_size());
 
-				memcpy(new_buf, m_begin, byte_size());
+				get_stats().on_reallocate(sizeof(value_type)*m_storage.dynamic_capacity(), result.size, result.ptr != data() ? byte_size() : 0);
+				m_storage.set_dynamic(pointer(result.ptr), result.size / sizeof(value_type));
+			}
 
-				m_alloc.free(m_dynamic_data);
 
-				m_dynamic_data = new_buf;
-				m_begin = m_dynamic_data;
-				m_dynamic_capacity = m_capacity;
-				m_end = m_begin + s;
-			}
+		}
 
 
+		// free the dynamic buffer kept while the static one is in use, the elements don't move
+		void release_spare() noexcept
+		{
+			if (m_storage.is_static() && m_storage.dynamic_ptr())
+			{
+				free_retained();
+			}
 		}
 
+		// give back all memory not holding elements: shrink_to_fit() and release_spare()
+		void trim()
+		{
+			shrink_to_fit();
+			release_spare();
+		}
 
 		void clear() noexcept
 		{
 			if (RevertToStaticSize > 0)
 			{
-				m_begin = m_end = static_begin_ptr();
-				m_capacity = StaticCapacity;
+				to_static();
 			}
 			else
 			{
-				m_end = m_begin;
+				m_storage.set_size(0);
 			}
 
 		}
@@ -475,6 +1166,14 @@ namespace ml
 
 
 
+		iterator insert(const_iterator position, size_type n, const value_type& val)
+		{
+			const T v = val;
+			auto pos = grow_at(position, n);
+			fill_not_aliased(pos, n, v);
+			return pos;
+		}
+
 		template <typename InputIterator, typename = decltype(*std::declval<InputIterator>())>
 		iterator insert(const_iterator position, InputIterator first, InputIterator last)
 		{
@@ -505,56 +1204,260 @@ namespace ml
 			return shrink_at(first, last - first);
 		}
 
+		// the elements [first, last) inserted before position by insert_many
+		struct insertion
+		{
+			const_iterator position;
+			const_pointer first;
+			const_pointer last;
+		};
+
+		// inserts all the ranges in one pass: at most one allocation, and every element moves at most once
+		// the ranges are sorted by position (in the vector as it is before the call, ranges at the same position
+		// go in their order) and mustn't point into the vector. iterators are invalidated
+		void insert_many(const insertion* ranges, size_type count)
+		{
+			const auto s = size();
+
+			size_t total = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				assert(ranges[i].position >= cbegin() && ranges[i].position <= cend());
+				assert(i == 0 || ranges[i - 1].position <= ranges[i].position);
+				assert(ranges[i].first <= ranges[i].last);
+				assert(ranges[i].first == ranges[i].last || ranges[i].last <= data() || ranges[i].first >= data() + capacity());
+
+				total += size_t(ranges[i].last - ranges[i].first);
+			}
+
+			if (!total) return;
+
+			const auto n = s + total;
+			assert(n <= max_size());
+
+			get_stats().on_size(n);
+
+			if (n <= capacity())
+			{
+				// back to front: every tail moves once to its final place, its range is copied in before it
+				const auto p = data();
+				auto end = s;
+				auto shift = total;
+
+				for (size_t i = count; i-- > 0;)
+				{
+					const auto at = size_t(ranges[i].position - cbegin());
+					const auto len = size_t(ranges[i].last - ranges[i].first);
+
+					std::memmove(p + at + shift, p + at, (end - at) * sizeof(T));
+					ML_SPV_COPIED((end - at) * sizeof(T));
+
+					shift -= len;
+					if (len) std::memcpy(p + at + shift, ranges[i].first, len * sizeof(T));
+					end = at;
+				}
+
+				m_storage.set_size(n);
+				return;
+			}
+
+			// a new buffer, the elements and the ranges gathered into it front to back
+			const auto from = data();
+			const buffer old = { m_storage.dynamic_ptr(), m_storage.dynamic_capacity() };
+			const bool was_static = m_storage.is_static();
+
+			assert(!impl::is_pinned(from));
+
+			const auto to = was_static ? choose_data(n) : allocate(grown_capacity(n));
+
+			auto w = to.data;
+			size_t read = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				const auto at = size_t(ranges[i].position - from);
+				const auto len = size_t(ranges[i].last - ranges[i].first);
+
+				std::memcpy(w, from + read, (at - read) * sizeof(T));
+				w += at - read;
+				if (len) std::memcpy(w, ranges[i].first, len * sizeof(T));
+				w += len;
+				read = at;
+			}
+			std::memcpy(w, from + read, (s - read) * sizeof(T));
+			ML_SPV_COPIED(s * sizeof(T));
+
+			if (was_static)
+			{
+				moved_to(to, n, old, true, s * sizeof(T));
+			}
+			else
+			{
+				deallocate(old);
+				get_stats().on_reallocate(sizeof(T) * old.capacity, sizeof(T) * to.capacity, s * sizeof(T));
+				m_storage.set_dynamic(to.data, to.capacity);
+				m_storage.set_size(n);
+			}
+		}
+
+		void insert_many(std::initializer_list<insertion> ranges)
+		{
+			insert_many(ranges.begin(), ranges.size());
+		}
+
+		// the elements [first, last) removed by erase_many
+		struct erasure
+		{
+			const_iterator first;
+			const_iterator last;
+		};
+
+		// erases all the ranges in one pass, every remaining element moves at most once
+		// the ranges are sorted and don't overlap. iterators are invalidated
+		void erase_many(const erasure* ranges, size_type count)
+		{
+			erase_sorted(count, [ranges](size_t i) { return ranges[i]; });
+		}
+
+		void erase_many(std::initializer_list<erasure> ranges)
+		{
+			erase_many(ranges.begin(), ranges.size());
+		}
+
+		// erases the elements at the sorted, distinct positions
+		void erase_many(const const_iterator* positions, size_type count)
+		{
+			erase_sorted(count, [positions](size_t i) { return erasure{ positions[i], positions[i] + 1 }; });
+		}
+
 		void push_back(const_reference val)
 		{
-			auto pos = grow_at(m_end, 1);
-			*pos = val;
+			emplace_back(val);
+		}
+
+		template <typename... Args>
+		reference emplace_back(Args&&... args)
+		{
+			const auto s = size();
+
+			if (ML_SPV_LIKELY(s < capacity()))
+			{
+				auto p = ::new (static_cast<void*>(m_storage.end_ptr())) T(std::forward<Args>(args)...);
+				m_storage.set_size(s + 1);
+				get_stats().on_size(s + 1);
+				return *p;
+			}
+
+			// the value may live in the buffer about to be replaced, so it's made first
+			return emplace_back_slow(T(std::forward<Args>(args)...));
+		}
+
+		// requires size() < capacity(). below RevertToStaticSize reserve() only records the dynamic
+		// buffer (capacity() doesn't change), so check capacity() rather than rely on reserve()
+		void push_back_unchecked(const_reference val)
+		{
+			const auto s = size();
+			assert(s < capacity());
+
+			*m_storage.end_ptr() = val;
+			m_storage.set_size(s + 1);
+			get_stats().on_size(s + 1);
 		}
 
 
 
 		void pop_back()
 		{
-			assert(m_end > m_begin);
-			m_end = m_end - 1;
+			assert(!empty());
+			m_storage.set_size(size() - 1);
 		}
 
 
+		// new elements are left uninitialized, same as resize_uninitialized()
 		void resize(size_type n)
 		{
-			auto new_buf = choose_data(n);
+			resize_uninitialized(n);
+		}
+
+		// new elements are set to value
+		void resize(size_type n, const T& value)
+		{
+			const auto s = size();
 
-			if (new_buf == m_begin)
+			if (n > s)
+			{
+				// the value may be an element, which resizing could move
+				const T v = value;
+				resize_uninitialized(n);
+				fill_not_aliased(data() + s, n - s, v);
+			}
+			else
 			{
-				reserve(n);
+				resize_uninitialized(n);
+			}
+		}
+
+		// grows by n elements set to value
+		void append_fill(size_type n, const T& value)
+		{
+			const T v = value;
+			fill_not_aliased(append_uninitialized(n), n, v);
+		}
+
+		// grows by n uninitialized elements, returns the first of them to be filled (by read(), a decoder...)
+		pointer append_uninitialized(size_type n)
+		{
+			return grow_at(end(), n);
+		}
+
+		// resizes to n uninitialized elements, then calls op(data(), n) that fills them and
+		// returns the size to keep (at most n), like std::basic_string::resize_and_overwrite
+		template <typename Operation>
+		void resize_and_overwrite(size_type n, Operation op)
+		{
+			resize_uninitialized(n);
+
+			const auto new_size = size_type(std::move(op)(data(), n));
+			assert(new_size <= n);
+
+			resize_uninitialized(new_size);
+		}
+
+		void resize_uninitialized(size_type n)
+		{
+			auto new_buf = choose_data(n);
 
-				m_end = m_begin + n;
+			if (new_buf.data == data())
+			{
+				m_storage.set_size(n);
 			}
 			else
 			{
 				// we need to transfer the elements into the new buffer
+				// (static <-> dynamic, a grown dynamic buffer is handled by choose_data)
 
-				memcpy(new_buf, m_begin, m_capacity * sizeof(value_type));
+				const auto s = size();
 
-				if (m_begin != static_begin_ptr())
+				if (n < s)
 				{
-					if (new_buf != static_begin_ptr())
-					{
-						assert(m_begin != m_dynamic_data);
-						m_alloc.free(m_begin);
-					}
-
+					move_to(new_buf, n, s - n, 0);
+				}
+				else
+				{
+					move_to(new_buf, s, 0, n - s);
 				}
-				update_capacity();
-
-				m_begin = new_buf;
-				m_end = new_buf + n;
 			}
 
+			get_stats().on_size(n);
 		}
 
 	private:
 
+		// the static buffer or a dynamic one
+		struct buffer
+		{
+			T* data;
+			size_t capacity;
+		};
 
 		static void copy_not_aliased(T* p, const T* begin, const T* end)
 		{
@@ -562,10 +1465,139 @@ namespace ml
 			std::memcpy(p, begin, s);
 		}
 
+		// value must not be in [p, p + n)
+		static void fill_not_aliased(T* p, size_t n, const T& value)
+		{
+			unsigned char bytes[sizeof(T)];
+			std::memcpy(bytes, &value, sizeof(T));
+
+			if (std::all_of(bytes + 1, bytes + sizeof(T), [&](unsigned char b) { return b == bytes[0]; }))
+			{
+				// 0, -1, a byte...
+				std::memset(p, bytes[0], n * sizeof(T));
+				return;
+			}
+
+			// a 64 byte block of the value, copied with fixed size memcpys that compile to broadcast vector stores
+			enum { block = sizeof(T) < 64 ? 64 / sizeof(T) : 1 };
+			T pattern[block];
+			for (size_t i = 0; i < block; ++i)
+			{
+				pattern[i] = value;
+			}
+
+			size_t i = 0;
+			for (; i + block <= n; i += block)
+			{
+				std::memcpy(p + i, pattern, sizeof(pattern));
+			}
+			std::memcpy(p + i, pattern, (n - i) * sizeof(T));
+		}
+
+		ML_SPV_NOINLINE reference emplace_back_slow(T val)
+		{
+			auto pos = grow_at(end(), 1);
+			*pos = val;
+			return *pos;
+		}
+
+		// move the elements to the other buffer, removing the elements [offset, offset + remove)
+		// and leaving a hole of insert uninitialized elements at offset
+		void move_to(buffer to, size_t offset, size_t remove, size_t insert)
+		{
+			const auto from = data();
+			const auto s = size();
+			const buffer old = { m_storage.dynamic_ptr(), m_storage.dynamic_capacity() };
+			const bool was_static = m_storage.is_static();
+
+			assert(to.data != from);
+			assert(!impl::is_pinned(from));
+			assert(offset + remove <= s);
+			assert(s - remove + insert <= to.capacity);
+
+			// going to the static buffer may overwrite the dynamic pointer (inline_union), it was saved in old
+			std::memcpy(to.data, from, offset * sizeof(T));
+			std::memcpy(to.data + offset + insert, from + offset + remove, (s - offset - remove) * sizeof(T));
+			ML_SPV_COPIED((s - remove) * sizeof(T));
+
+			moved_to(to, s - remove + insert, old, was_static, (s - remove) * sizeof(T));
+		}
+
+		// the elements were copied to the other buffer, old is the dynamic buffer before the copy
+		void moved_to(buffer to, size_t new_size, buffer old, bool was_static, size_t copied)
+		{
+			if (to.data == m_storage.static_ptr())
+			{
+				m_storage.use_static(new_size);
+
+				if (!was_static)
+				{
+					get_stats().on_revert(copied);
+				}
+
+				if (!was_static && !retain(old.capacity))
+				{
+					deallocate(old);
+					m_storage.set_dynamic(nullptr, 0);
+				}
+			}
+			else
+			{
+				assert(was_static); // growing the dynamic buffer is grow_dynamic's job
+				m_storage.use_dynamic(to.data, to.capacity, new_size);
+				get_stats().on_spill(copied);
+			}
+		}
+
+		// whether to keep a dynamic buffer of capacity elements while in the static one
+		static bool retain(size_t capacity)
+		{
+			return storage_type::retains_dynamic && RetentionPolicy::retain(sizeof(value_type) * capacity);
+		}
+
+		// move the elements to the static buffer and empty it
+		void to_static()
+		{
+			if (!m_storage.is_static())
+			{
+				move_to({ m_storage.static_ptr(), StaticCapacity }, 0, size(), 0);
+			}
+			else
+			{
+				m_storage.set_size(0);
+			}
+		}
 
-		T* static_begin_ptr()
+		// takes the elements and the dynamic buffer of v, leaving it empty
+		void take(small_pod_vector& v)
 		{
-			return reinterpret_cast<pointer>(m_static_data + 0);
+			assert(empty() && m_storage.is_static() && !m_storage.dynamic_ptr());
+
+			const auto s = v.size();
+
+			if (v.m_storage.is_static())
+			{
+				// a dynamic buffer changes hands, the static one is left behind
+				assert(!impl::is_pinned(v.data()));
+
+				std::memcpy(m_storage.static_ptr(), v.data(), v.byte_size());
+				m_storage.use_static(s);
+
+				if (v.m_storage.dynamic_ptr())
+				{
+					// the retained buffer comes along
+					m_storage.set_dynamic(v.m_storage.dynamic_ptr(), v.m_storage.dynamic_capacity());
+				}
+			}
+			else
+			{
+				m_storage.use_dynamic(v.m_storage.dynamic_ptr(), v.m_storage.dynamic_capacity(), s);
+			}
+
+			v.m_storage.use_static(0);
+			v.m_storage.set_dynamic(nullptr, 0);
+
+			get_stats().on_move_from(v.get_stats());
 		}
 
 		// increase the size by splicing the elements in such a way that
@@ -573,43 +1605,91 @@ namespace ml
 		// returns the (potentially new) address of the hole
 		T* grow_at(const T* cp, size_t num)
 		{
-			auto position = const_cast<T*>(cp);
-
-			assert(!(position < m_begin || position > m_end));
+			assert(!(cp < begin() || cp > end()));
 
-			const auto offset = cp - m_begin;
+			const auto offset = size_t(cp - begin());
 			const auto s = size();
+
+			get_stats().on_size(s + num);
+
+			if (!m_storage.is_static() && s + num > m_storage.dynamic_capacity())
+			{
+				// the dynamic buffer grows with the hole already in place
+				grow_dynamic(grown_capacity(s + num), offset, num);
+				m_storage.set_size(s + num);
+				return data() + offset;
+			}
+
 			auto new_buf = choose_data(s + num);
 
-			if (new_buf == m_begin)
+			if (new_buf.data == data())
 			{
-				std::memmove(m_begin + offset + num, m_begin + offset, (s - offset) * sizeof(value_type));
-				m_end = m_begin + s + num;
-				return m_begin + offset;
+				std::memmove(new_buf.data + offset + num, new_buf.data + offset, (s - offset) * sizeof(value_type));
+				ML_SPV_COPIED((s - offset) * sizeof(value_type));
+				m_storage.set_size(s + num);
 			}
 			else
 			{
 				// we need to transfer the elements into the new buffer
+				move_to(new_buf, offset, 0, num);
+			}
 
-				position = new_buf + (position - m_begin);
+			return new_buf.data + offset;
+		}
+
+		// erases the ranges get(0) ... get(count - 1), front to back, the remaining elements gathered
+		// in the current buffer or, when the size drops below RevertToStaticSize, in the static one
+		template <typename GetRange>
+		void erase_sorted(size_t count, GetRange get)
+		{
+			const auto s = size();
 
-				memcpy(new_buf, m_begin, m_capacity * sizeof(value_type));
+			size_t removed = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				const auto r = get(i);
+				assert(r.first >= cbegin() && r.first <= r.last && r.last <= cend());
+				assert(i == 0 || get(i - 1).last <= r.first);
 
-				std::memmove(new_buf + offset + num, new_buf + offset, (s - offset) * sizeof(value_type));
+				removed += size_t(r.last - r.first);
+			}
 
-				if (m_begin != static_begin_ptr())
-				{
-					//deallocate old memory
-					assert(m_begin != m_dynamic_data);
-					m_alloc.free(m_begin);
-				}
+			if (!removed) return;
 
-				m_capacity = m_dynamic_capacity;
+			const auto n = s - removed;
+			const auto from = data();
+			const buffer old = { m_storage.dynamic_ptr(), m_storage.dynamic_capacity() };
+			const bool was_static = m_storage.is_static();
 
-				m_begin = new_buf;
-				m_end = new_buf + s + num;
+			const auto to = choose_data(n);
 
-				return position;
+			// the front, up to the first range, only moves when the buffer changes
+			auto w = to.data;
+			size_t read = 0;
+			size_t copied = 0;
+			for (size_t i = 0; i <= count; ++i)
+			{
+				const auto keep_end = i < count ? size_t(get(i).first - from) : s;
+				const auto len = keep_end - read;
+
+				if (w != from + read)
+				{
+					std::memmove(w, from + read, len * sizeof(T));
+					copied += len * sizeof(T);
+				}
+				w += len;
+				read = i < count ? size_t(get(i).last - from) : s;
+			}
+			ML_SPV_COPIED(copied);
+
+			if (to.data == from)
+			{
+				m_storage.set_size(n);
+			}
+			else
+			{
+				assert(!impl::is_pinned(from));
+				moved_to(to, n, old, was_static, copied);
 			}
 		}
 
@@ -617,172 +1697,183 @@ namespace ml
 		{
 			auto position = const_cast<T*>(cp);
 
-			assert(!(position < m_begin || position > m_end || position + num > m_end));
+			assert(!(position < begin() || position > end() || position + num > end()));
 
 			const auto s = size();
+			const auto offset = size_t(position - begin());
 
 			auto new_buf = choose_data(s - num);
 
-			if (new_buf == m_begin)
+			if (new_buf.data == data())
 			{
-				std::memmove(position, position + num, size_t(m_end - position - num) * sizeof(T));
+				std::memmove(position, position + num, size_t(s - offset - num) * sizeof(T));
+				ML_SPV_COPIED(size_t(s - offset - num) * sizeof(T));
 
-				m_end -= num;
+				m_storage.set_size(s - num);
 			}
 			else
 			{
 				// we need to transfer the elements into the new buffer
 
-				assert(new_buf == static_begin_ptr()); // since we're shrinking that's the only way to have a new buffer
-
-				m_capacity = StaticCapacity;
-
-				memcpy(new_buf, m_begin, byte_size());
-
-				auto offset = position - m_begin;
-
-				std::memmove(new_buf + offset, new_buf + offset + num, (s - offset) * sizeof(T));
-
-				position = new_buf + offset;
-
-				m_begin = new_buf;
-				m_end = new_buf + (s - num);
+				assert(new_buf.data == m_storage.static_ptr()); // since we're shrinking that's the only way to have a new buffer
 
+				move_to(new_buf, offset, num, 0);
 			}
 
-			return position;
+			return new_buf.data + offset;
 		}
 
 		void assign_impl(size_type count, const T& value)
 		{
-			assert(m_begin);
-			assert(m_begin == m_end);
+			assert(empty());
 
-			m_begin = m_end = choose_data(count);
+			const T v = value;
 
-			for (size_type i = 0; i < count; ++i)
-			{
-				*m_end = value;
-
-				++m_end;
-			}
+			resize(count);
 
-			update_capacity();
+			fill_not_aliased(data(), count, v);
 		}
 
 		template <class InputIterator>
 		void assign_impl(InputIterator first, InputIterator last)
 		{
-			assert(m_begin);
-			assert(m_begin == m_end);
+			assert(empty());
 
-			m_begin = choose_data(last - first);
+			resize(last - first);
 
-			copy_not_aliased(m_begin, first, last);
-
-			m_end = m_begin + (last - first);
-
-			update_capacity();
+			copy_not_aliased(data(), first, last);
 		}
 
 		void assign_impl(std::initializer_list<T> ilist)
 		{
-			assert(m_begin);
-			assert(m_begin == m_end);
-
-			m_begin = choose_data(ilist.size());
-
-			copy_not_aliased(m_begin, ilist.begin(), ilist.end());
+			assert(empty());
 
-			m_end = m_begin + ilist.size();
+			resize(ilist.size());
 
-			update_capacity();
+			copy_not_aliased(data(), ilist.begin(), ilist.end());
 		}
 
-		void update_capacity()
+		// the buffer to hold desired_capacity elements. it's the current one, a grown current
+		// dynamic one (the elements have moved along), the static one, the retained dynamic one
+		// or a newly allocated one, which the caller has to move into
+		buffer choose_data(size_t desired_capacity)
 		{
-			m_capacity = m_begin == static_begin_ptr() ? StaticCapacity : m_dynamic_capacity;
+			assert(desired_capacity <= max_size());
 
-		}
-
-		T* choose_data(size_t desired_capacity)
-		{
-			if (m_begin == m_dynamic_data)
+			if (!m_storage.is_static())
 			{
 				// we're at the dyn buffer, so see if it needs resize or revert to static
 
-				if (desired_capacity > m_dynamic_capacity)
+				if (desired_capacity > m_storage.dynamic_capacity())
 				{
-
-					while (m_dynamic_capacity < desired_capacity)
-					{
-						m_dynamic_capacity *= 2;
-
-					}
-					m_dynamic_data = pointer(m_alloc.malloc(sizeof(value_type)*m_dynamic_capacity));
-					return m_dynamic_data;
+					grow_dynamic(grown_capacity(desired_capacity), size(), 0);
+					return { m_storage.dynamic_ptr(), m_storage.dynamic_capacity() };
 				}
 				else if (desired_capacity < RevertToStaticSize)
 				{
 					// we're reverting to the static buffer
-					return static_begin_ptr();
+					return { m_storage.static_ptr(), StaticCapacity };
 				}
 				else
 				{
 					// if the capacity and we don't revert to static, just do nothing
-					return m_dynamic_data;
+					return { m_storage.dynamic_ptr(), m_storage.dynamic_capacity() };
 				}
 			}
 			else
 			{
-				assert(m_begin == static_begin_ptr()); // corrupt begin ptr?
-
 				if (desired_capacity > StaticCapacity)
 				{
 					// we must move to dyn memory
 
 					// see if we have enough
-					if (desired_capacity > m_dynamic_capacity)
+					if (desired_capacity <= m_storage.dynamic_capacity())
 					{
-						// we need to allocate more
-
-						if (m_dynamic_data)
-						{
-							m_alloc.free(m_dynamic_data);
-						}
+						return { m_storage.dynamic_ptr(), m_storage.dynamic_capacity() };
+					}
 
-						m_dynamic_capacity = desired_capacity;
-						//add a little more
-						m_dynamic_capacity += 4;
+					// we need to allocate more
 
-						m_dynamic_data = pointer(m_alloc.malloc(sizeof(value_type)*m_dynamic_capacity));
+					if (m_storage.dynamic_ptr())
+					{
+						free_retained();
 					}
 
-					return m_dynamic_data;
+					const auto new_capacity = GrowthPolicy::spill_capacity(StaticCapacity, desired_capacity, sizeof(value_type));
+					assert(new_capacity >= desired_capacity);
+
+					return allocate(new_capacity);
 				}
 				else
 				{
 					// we have enough capacity as it is
-					return static_begin_ptr();
+					return { m_storage.static_ptr(), StaticCapacity };
 				}
 			}
 		}
 
-		allocator_type& get_alloc() { return static_cast<allocator_type&>(*this); }
-		const allocator_type& get_alloc() const { return static_cast<const allocator_type&>(*this); }
+		// the allocator may hand back more than asked for, which becomes extra capacity
+		buffer allocate(size_t capacity)
+		{
+			auto result = impl::alloc_traits<Alloc>::allocate(get_alloc(), sizeof(value_type)*capacity);
+			get_stats().on_allocate(result.size);
+
+			return { pointer(result.ptr), result.size / sizeof(value_type) };
+		}
+
+		void deallocate(buffer buf)
+		{
+			impl::alloc_traits<Alloc>::deallocate(get_alloc(), buf.data, sizeof(value_type)*buf.capacity);
+			get_stats().on_free(sizeof(value_type)*buf.capacity);
+		}
+
+		// free the dynamic buffer kept while in the static one
+		void free_retained()
+		{
+			assert(m_storage.is_static());
+
+			deallocate({ m_storage.dynamic_ptr(), m_storage.dynamic_capacity() });
+
+			m_storage.set_dynamic(nullptr, 0);
+		}
+
+		// the capacity the dynamic buffer grows to, to hold desired_capacity elements
+		size_t grown_capacity(size_t desired_capacity) const
+		{
+			const auto new_capacity = GrowthPolicy::grow_capacity(m_storage.dynamic_capacity(), desired_capacity, sizeof(value_type));
+			assert(new_capacity >= desired_capacity);
+			return new_capacity;
+		}
+
+		// grow the dynamic buffer we're in, keeping the elements and leaving a hole of gap elements at offset
+		// callers see the result of choose_data() as the current buffer
+		void grow_dynamic(size_t new_capacity, size_t offset, size_t gap)
+		{
+			assert(!m_storage.is_static());
+			assert(!impl::is_pinned(data()));
 
-		pointer m_begin;
-		pointer m_end;
+			const auto ts = sizeof(value_type);
+			auto result = impl::alloc_traits<Alloc>::reallocate(get_alloc(), data(), ts * m_storage.dynamic_capacity(), ts * new_capacity, byte_size(), ts * offset, ts * gap);
 
-		size_t m_capacity;
-		typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type m_static_data[StaticCapacity];
+			get_stats().on_reallocate(ts * m_storage.dynamic_capacity(), result.size, result.ptr != data() ? byte_size() : 0);
+			m_storage.set_dynamic(pointer(result.ptr), result.size / ts);
+		}
+
+		using impl::alloc_holder<Alloc>::get_alloc;
+		using impl::stats_holder<StatsPolicy>::get_stats;
 
-		size_t m_dynamic_capacity;
-		pointer m_dynamic_data;
-		Alloc m_alloc;
+		storage_type m_storage;
 
 	};
 
+	// header of 16 bytes (with the default 32-bit sizes) instead of 40, begin() and capacity() branch
+	template<typename T, size_t StaticCapacity = 16, size_t RevertToStaticSize = 0, class Alloc = impl::pod_allocator, class GrowthPolicy = growth::tight_spill, class RetentionPolicy = retention::keep, class StatsPolicy = stats::none>
+	using compact_small_pod_vector = small_pod_vector<T, StaticCapacity, RevertToStaticSize, Alloc, GrowthPolicy, layout::compact<>, RetentionPolicy, StatsPolicy>;
+
+	// SSO style vector of (with an empty allocator) exactly ObjectSize bytes, as many elements as fit are static
+	template<typename T, size_t ObjectSize = 32, class Alloc = impl::pod_allocator, class GrowthPolicy = growth::doubling, class StatsPolicy = stats::none>
+	using sso_pod_vector = small_pod_vector<T, layout::inline_union<>::capacity_for<T, ObjectSize>::value, 0, Alloc, GrowthPolicy, layout::inline_union<>, retention::keep, StatsPolicy>;
+
 
 
 }
@@ -0,0 +1,747 @@
+
+// ml-small_pod_vector allocators v1.02
+
+
+//                  VERSION HISTORY
+//
+//  1.00 pool_allocator
+//  1.01 arena / arena_allocator
+//  1.02 mmap_allocator (linux)
+
+// allocators meeting the Alloc concept of ml::small_pod_vector (see small_pod_vector.hpp)
+
+#pragma once
+
+#include "small_pod_vector.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace ml
+{
+
+	namespace impl
+	{
+		// thread-local size class pool. freed dynamic buffers are kept per thread and size class
+		// and handed out again instead of going back to std::malloc
+		//
+		// size classes are powers of two from 32 bytes to 1MB, larger blocks go straight to std::malloc
+		// every block carries a small header naming the thread heap that owns it. a block freed by
+		// another thread is pushed on the owner's lock-free remote list, which the owner drains when
+		// its own list of that size class runs dry
+		// the heap of an exiting thread is parked (with its cache) and adopted by the next new thread
+		class pool_allocator
+		{
+		public:
+			using size_type = size_t;
+
+			static constexpr size_t min_block_size = 32;
+			static constexpr size_t size_classes = 16;
+			static constexpr size_t max_block_size = min_block_size << (size_classes - 1);
+			// blocks kept per thread and size class, the rest is returned to std::free
+			static constexpr size_t max_cached_blocks = 64;
+
+			struct statistics
+			{
+				uint64_t allocations = 0;			// all allocations
+				uint64_t pool_hits = 0;				// allocations served from the pool
+				uint64_t frees = 0;					// all frees
+				uint64_t remote_frees = 0;			// frees of blocks owned by another thread
+				uint64_t system_allocations = 0;	// std::malloc calls
+				uint64_t system_frees = 0;			// std::free calls
+				uint64_t cached_bytes = 0;			// bytes held by the pools (not counting blocks in remote lists)
+			};
+
+			static void* malloc(size_type size)
+			{
+				return allocate_at_least(size).ptr;
+			}
+
+			static allocation_result allocate_at_least(size_type size)
+			{
+				auto h = current_heap();
+				const auto c = size_class(size);
+
+				if (c == size_classes)
+				{
+					// too big to pool
+					if (h) h->count(h->allocations);
+					return { system_allocate(h, size, nullptr, c), size };
+				}
+
+				const auto block_size = min_block_size << c;
+
+				if (!h)
+				{
+					// the thread is exiting, no heap to serve from
+					return { system_allocate(nullptr, block_size, nullptr, c), block_size };
+				}
+
+				h->count(h->allocations);
+
+				auto b = h->pop(c);
+				if (!b)
+				{
+					h->drain_remote();
+					b = h->pop(c);
+				}
+
+				if (b)
+				{
+					h->count(h->pool_hits);
+					return { payload(b), block_size };
+				}
+
+				return { system_allocate(h, block_size, h, c), block_size };
+			}
+
+			static void free(void* mem)
+			{
+				if (!mem) return;
+
+				auto b = header_of(mem);
+				auto h = current_heap();
+
+				if (h) h->count(h->frees);
+
+				if (!b->owner)
+				{
+					system_free(h, b);
+				}
+				else if (b->owner == h)
+				{
+					if (!h->push(b))
+					{
+						system_free(h, b);
+					}
+				}
+				else
+				{
+					if (h) h->count(h->remote_frees);
+					b->owner->push_remote(b);
+				}
+			}
+
+			// summed over all threads that ever used the pool
+			static statistics stats()
+			{
+				statistics s;
+
+				auto& r = get_registry();
+				std::lock_guard<std::mutex> lock(r.mutex);
+
+				for (auto h = r.all; h; h = h->next_registered)
+				{
+					s.allocations += h->allocations.load(std::memory_order_relaxed);
+					s.pool_hits += h->pool_hits.load(std::memory_order_relaxed);
+					s.frees += h->frees.load(std::memory_order_relaxed);
+					s.remote_frees += h->remote_frees.load(std::memory_order_relaxed);
+					s.system_allocations += h->system_allocations.load(std::memory_order_relaxed);
+					s.system_frees += h->system_frees.load(std::memory_order_relaxed);
+					s.cached_bytes += h->cached_bytes.load(std::memory_order_relaxed);
+				}
+
+				return s;
+			}
+
+		private:
+			struct heap;
+
+			// 16 bytes keeps the payload aligned like std::malloc's
+			struct alignas(16) block
+			{
+				heap* owner;
+				size_t size_class;
+			};
+
+			// while a block is cached its payload holds the link to the next one
+			static block*& next_of(block* b)
+			{
+				return *reinterpret_cast<block**>(payload(b));
+			}
+
+			static void* payload(block* b)
+			{
+				return b + 1;
+			}
+
+			static block* header_of(void* mem)
+			{
+				return static_cast<block*>(mem) - 1;
+			}
+
+			static size_t size_class(size_t size)
+			{
+				if (size > max_block_size) return size_classes;
+				if (size <= min_block_size) return 0;
+
+#if defined(__GNUC__)
+				return size_t(64 - __builtin_clzll((unsigned long long)(size - 1))) - 5;
+#else
+				size_t c = 0;
+				while ((min_block_size << c) < size)
+				{
+					++c;
+				}
+				return c;
+#endif
+			}
+
+			struct heap
+			{
+				block* free_lists[size_classes] = {};
+				size_t cached[size_classes] = {};
+
+				// blocks freed by other threads, any size class
+				std::atomic<block*> remote{ nullptr };
+
+				// only written by the thread owning the heap (a remote free is counted by the freeing thread's heap), read by stats()
+				std::atomic<uint64_t> allocations{ 0 };
+				std::atomic<uint64_t> pool_hits{ 0 };
+				std::atomic<uint64_t> frees{ 0 };
+				std::atomic<uint64_t> remote_frees{ 0 };
+				std::atomic<uint64_t> system_allocations{ 0 };
+				std::atomic<uint64_t> system_frees{ 0 };
+				std::atomic<uint64_t> cached_bytes{ 0 };
+
+				heap* next_registered = nullptr;
+				heap* next_parked = nullptr;
+
+				// single writer, so no read-modify-write needed
+				static void count(std::atomic<uint64_t>& counter, int64_t n = 1)
+				{
+					counter.store(counter.load(std::memory_order_relaxed) + uint64_t(n), std::memory_order_relaxed);
+				}
+
+				block* pop(size_t c)
+				{
+					auto b = free_lists[c];
+					if (b)
+					{
+						free_lists[c] = next_of(b);
+						--cached[c];
+						count(cached_bytes, -int64_t(min_block_size << c));
+					}
+					return b;
+				}
+
+				bool push(block* b)
+				{
+					const auto c = b->size_class;
+					if (cached[c] == max_cached_blocks) return false;
+
+					next_of(b) = free_lists[c];
+					free_lists[c] = b;
+					++cached[c];
+					count(cached_bytes, int64_t(min_block_size << c));
+					return true;
+				}
+
+				void push_remote(block* b)
+				{
+					auto head = remote.load(std::memory_order_relaxed);
+					do
+					{
+						next_of(b) = head;
+					} while (!remote.compare_exchange_weak(head, b, std::memory_order_release, std::memory_order_relaxed));
+				}
+
+				void drain_remote()
+				{
+					// taking the whole list at once can't suffer from ABA
+					auto b = remote.exchange(nullptr, std::memory_order_acquire);
+					while (b)
+					{
+						auto next = next_of(b);
+						if (!push(b))
+						{
+							system_free(this, b);
+						}
+						b = next;
+					}
+				}
+			};
+
+			struct registry
+			{
+				std::mutex mutex;
+				heap* all = nullptr;
+				heap* parked = nullptr;
+			};
+
+			static registry& get_registry()
+			{
+				// never destroyed, blocks may be freed during static destruction
+				static registry* r = new registry;
+				return *r;
+			}
+
+			// adopts a parked heap or creates one for the current thread, parks it again on thread exit
+			struct heap_owner
+			{
+				heap* h;
+
+				heap_owner()
+				{
+					auto& r = get_registry();
+					std::lock_guard<std::mutex> lock(r.mutex);
+
+					if (r.parked)
+					{
+						h = r.parked;
+						r.parked = h->next_parked;
+					}
+					else
+					{
+						h = new heap;
+						h->next_registered = r.all;
+						r.all = h;
+					}
+				}
+
+				~heap_owner()
+				{
+					thread_heap() = exited_heap();
+
+					auto& r = get_registry();
+					std::lock_guard<std::mutex> lock(r.mutex);
+
+					h->next_parked = r.parked;
+					r.parked = h;
+				}
+			};
+
+			static heap*& thread_heap()
+			{
+				// trivially destructible, so it can still be read after heap_owner is gone
+				static thread_local heap* h = nullptr;
+				return h;
+			}
+
+			static heap* exited_heap()
+			{
+				return reinterpret_cast<heap*>(uintptr_t(1));
+			}
+
+			// nullptr once the thread's heap has been parked
+			static heap* current_heap()
+			{
+				auto& h = thread_heap();
+				if (!h)
+				{
+					static thread_local heap_owner owner;
+					h = owner.h;
+				}
+				return h == exited_heap() ? nullptr : h;
+			}
+
+			static void* system_allocate(heap* h, size_t size, heap* owner, size_t c)
+			{
+				if (h) heap::count(h->system_allocations);
+
+				auto b = static_cast<block*>(std::malloc(sizeof(block) + size));
+				b->owner = owner;
+				b->size_class = c;
+				return payload(b);
+			}
+
+			static void system_free(heap* h, block* b)
+			{
+				if (h) heap::count(h->system_frees);
+
+				std::free(b);
+			}
+		};
+
+		// monotonic bump allocator. memory is only given back all at once, by reset() or release()
+		// the most recent allocation can be grown in place while its chunk has room
+		class arena
+		{
+		public:
+			static constexpr size_t alignment = 16;
+
+			explicit arena(size_t chunk_size = 64 * 1024)
+				: m_chunk_size(chunk_size)
+			{}
+
+			arena(const arena&) = delete;
+			arena& operator=(const arena&) = delete;
+
+			~arena()
+			{
+				release();
+			}
+
+			void* allocate(size_t size)
+			{
+				size = round(size);
+
+				if (size_t(m_end - m_cur) < size)
+				{
+					add_chunk(size);
+				}
+
+				m_last = m_cur;
+				m_cur += size;
+				m_used += size;
+				return m_last;
+			}
+
+			bool try_expand(void* mem, size_t old_size, size_t new_size)
+			{
+				if (mem != m_last) return false;
+
+				const auto extra = round(new_size) - round(old_size);
+				if (size_t(m_end - m_cur) < extra) return false;
+
+				m_cur += extra;
+				m_used += extra;
+				return true;
+			}
+
+			// forget all allocations, keeping the current chunk for reuse
+			void reset()
+			{
+				if (!m_chunks) return;
+
+				auto keep = m_chunks;
+				m_chunks = m_chunks->prev;
+				release();
+
+				keep->prev = nullptr;
+				m_chunks = keep;
+				m_reserved = keep->size;
+				m_cur = reinterpret_cast<char*>(keep + 1);
+				m_end = m_cur + keep->size;
+			}
+
+			// free all chunks
+			void release()
+			{
+				while (m_chunks)
+				{
+					auto prev = m_chunks->prev;
+					std::free(m_chunks);
+					m_chunks = prev;
+				}
+
+				m_cur = m_end = nullptr;
+				m_last = nullptr;
+				m_used = 0;
+				m_reserved = 0;
+			}
+
+			// bytes handed out since the last reset/release
+			size_t bytes_used() const
+			{
+				return m_used;
+			}
+
+			// bytes held in chunks
+			size_t bytes_reserved() const
+			{
+				return m_reserved;
+			}
+
+		private:
+			struct alignas(alignment) chunk
+			{
+				chunk* prev;
+				size_t size;
+			};
+
+			static size_t round(size_t size)
+			{
+				return (size + alignment - 1) & ~(alignment - 1);
+			}
+
+			void add_chunk(size_t size)
+			{
+				// an oversized allocation gets a chunk of its own size
+				const auto chunk_size = size > m_chunk_size ? size : m_chunk_size;
+
+				auto c = static_cast<chunk*>(std::malloc(sizeof(chunk) + chunk_size));
+				c->prev = m_chunks;
+				c->size = chunk_size;
+
+				m_chunks = c;
+				m_reserved += chunk_size;
+				m_cur = reinterpret_cast<char*>(c + 1);
+				m_end = m_cur + chunk_size;
+			}
+
+			size_t m_chunk_size;
+			chunk* m_chunks = nullptr;
+			char* m_cur = nullptr;
+			char* m_end = nullptr;
+			void* m_last = nullptr;
+			size_t m_used = 0;
+			size_t m_reserved = 0;
+		};
+
+		// stateful handle to an arena. free is a no-op
+		class arena_allocator
+		{
+		public:
+			using size_type = size_t;
+
+			arena_allocator(arena& a)
+				: m_arena(&a)
+			{}
+
+			void* malloc(size_type size) { return m_arena->allocate(size); }
+			void free(void*) {}
+
+			bool try_expand_in_place(void* mem, size_type old_size, size_type new_size) { return m_arena->try_expand(mem, old_size, new_size); }
+
+			arena& get_arena() const { return *m_arena; }
+
+		private:
+			arena* m_arena;
+		};
+
+#if defined(__linux__)
+		namespace mmap_options
+		{
+			enum : unsigned
+			{
+				none = 0,
+				huge_pages = 1,		// 2MB aligned mappings with MADV_HUGEPAGE (transparent huge pages)
+				hugetlb = 2,		// MAP_HUGETLB from the reserved huge page pool, falling back to a plain mapping
+				populate = 4,		// prefault with MAP_POPULATE (and MADV_POPULATE_WRITE when growing)
+			};
+		}
+
+		// blocks of Threshold bytes and more are mapped straight from the kernel, smaller ones come from std::malloc
+		// a mapped block grows with mremap, so the pages are moved instead of the bytes. with huge pages the
+		// mappings are whole 2MB pages, otherwise whole pages
+		template<size_t Threshold = size_t(1) << 21, unsigned Options = mmap_options::huge_pages>
+		class mmap_allocator
+		{
+		public:
+			using size_type = size_t;
+
+			static constexpr size_t threshold = Threshold;
+			static constexpr size_t huge_page_size = size_t(1) << 21;
+
+			struct statistics
+			{
+				uint64_t maps = 0;				// mmap calls
+				uint64_t unmaps = 0;			// munmap calls
+				uint64_t remaps = 0;			// mremap calls that grew or shrank a block without copying
+				uint64_t hugetlb_fallbacks = 0;	// MAP_HUGETLB failed, a plain mapping was used
+				uint64_t mapped_bytes = 0;		// bytes mapped right now
+			};
+
+			static allocation_result allocate_at_least(size_type size)
+			{
+				if (size < Threshold)
+				{
+					return { std::malloc(size), size };
+				}
+
+				const auto bytes = round(size);
+				return { map(bytes), bytes };
+			}
+
+			// size is between the requested and the real size, both round to the real size
+			static void free(void* mem, size_type size)
+			{
+				if (size < Threshold)
+				{
+					std::free(mem);
+				}
+				else if (mem)
+				{
+					unmap(mem, round(size));
+				}
+			}
+
+			static void* realloc(void* mem, size_type old_size, size_type new_size)
+			{
+				if (old_size < Threshold && new_size < Threshold)
+				{
+					return std::realloc(mem, new_size);
+				}
+
+				if (old_size >= Threshold && new_size >= Threshold)
+				{
+					const auto old_bytes = round(old_size);
+					const auto new_bytes = round(new_size);
+					if (old_bytes == new_bytes) return mem;
+
+					auto p = ::mremap(mem, old_bytes, new_bytes, MREMAP_MAYMOVE);
+					if (p != MAP_FAILED)
+					{
+						count(counters().remaps);
+						counters().mapped_bytes.fetch_add(new_bytes - old_bytes, std::memory_order_relaxed);
+						if (new_bytes > old_bytes)
+						{
+							advise(static_cast<char*>(p) + old_bytes, new_bytes - old_bytes);
+						}
+						return p;
+					}
+				}
+
+				// across the threshold (or mremap refused, as it may for hugetlb): a new block and a copy
+				auto p = allocate_at_least(new_size).ptr;
+				std::memcpy(p, mem, old_size < new_size ? old_size : new_size);
+				free(mem, old_size);
+				return p;
+			}
+
+			// a mapping grows in place when the address space after it is free
+			static bool try_expand_in_place(void* mem, size_type old_size, size_type new_size)
+			{
+				if (old_size < Threshold) return false;
+
+				const auto old_bytes = round(old_size);
+				const auto new_bytes = round(new_size);
+				if (old_bytes == new_bytes) return true;
+
+				if (::mremap(mem, old_bytes, new_bytes, 0) == MAP_FAILED) return false;
+
+				count(counters().remaps);
+				counters().mapped_bytes.fetch_add(new_bytes - old_bytes, std::memory_order_relaxed);
+				advise(static_cast<char*>(mem) + old_bytes, new_bytes - old_bytes);
+				return true;
+			}
+
+			// per instantiation, over all threads
+			static statistics stats()
+			{
+				statistics s;
+				s.maps = counters().maps.load(std::memory_order_relaxed);
+				s.unmaps = counters().unmaps.load(std::memory_order_relaxed);
+				s.remaps = counters().remaps.load(std::memory_order_relaxed);
+				s.hugetlb_fallbacks = counters().hugetlb_fallbacks.load(std::memory_order_relaxed);
+				s.mapped_bytes = counters().mapped_bytes.load(std::memory_order_relaxed);
+				return s;
+			}
+
+		private:
+			static constexpr bool use_huge_pages = (Options & (mmap_options::huge_pages | mmap_options::hugetlb)) != 0;
+
+			struct atomic_statistics
+			{
+				std::atomic<uint64_t> maps{ 0 };
+				std::atomic<uint64_t> unmaps{ 0 };
+				std::atomic<uint64_t> remaps{ 0 };
+				std::atomic<uint64_t> hugetlb_fallbacks{ 0 };
+				std::atomic<uint64_t> mapped_bytes{ 0 };
+			};
+
+			static atomic_statistics& counters()
+			{
+				// never destroyed, blocks may be freed during static destruction
+				static atomic_statistics* c = new atomic_statistics;
+				return *c;
+			}
+
+			static void count(std::atomic<uint64_t>& counter)
+			{
+				counter.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			static size_t granularity()
+			{
+				static const size_t page = size_t(::sysconf(_SC_PAGESIZE));
+				return use_huge_pages ? huge_page_size : page;
+			}
+
+			static size_t round(size_t size)
+			{
+				const auto g = granularity();
+				return (size + g - 1) / g * g;
+			}
+
+			static void* map(size_t bytes)
+			{
+				const int populate = (Options & mmap_options::populate) ? MAP_POPULATE : 0;
+				void* p = MAP_FAILED;
+
+				if (Options & mmap_options::hugetlb)
+				{
+					p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | populate, -1, 0);
+					if (p == MAP_FAILED)
+					{
+						count(counters().hugetlb_fallbacks);
+					}
+				}
+
+				if (p == MAP_FAILED)
+				{
+					p = use_huge_pages ? map_aligned(bytes) : ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | populate, -1, 0);
+				}
+
+				if (p == MAP_FAILED) throw std::bad_alloc();
+
+				count(counters().maps);
+				counters().mapped_bytes.fetch_add(bytes, std::memory_order_relaxed);
+				return p;
+			}
+
+			// over-maps by a huge page and trims, so the block starts on a huge page boundary
+			// and the kernel can back it with huge pages from the first byte
+			static void* map_aligned(size_t bytes)
+			{
+				auto p = ::mmap(nullptr, bytes + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+				if (p == MAP_FAILED) return p;
+
+				const auto raw = reinterpret_cast<uintptr_t>(p);
+				const auto aligned = (raw + huge_page_size - 1) & ~uintptr_t(huge_page_size - 1);
+				if (aligned > raw)
+				{
+					::munmap(p, aligned - raw);
+				}
+				const auto tail = raw + huge_page_size - aligned;
+				if (tail)
+				{
+					::munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+				}
+
+				auto mem = reinterpret_cast<void*>(aligned);
+				advise(mem, bytes);
+				return mem;
+			}
+
+			// huge pages and prefaulting for freshly mapped bytes
+			static void advise(void* mem, size_t bytes)
+			{
+#ifdef MADV_HUGEPAGE
+				if (Options & mmap_options::huge_pages)
+				{
+					::madvise(mem, bytes, MADV_HUGEPAGE);
+				}
+#endif
+				if (Options & mmap_options::populate)
+				{
+#ifdef MADV_POPULATE_WRITE
+					if (::madvise(mem, bytes, MADV_POPULATE_WRITE) == 0) return;
+#endif
+					// older kernels: a write per page
+					const auto page = size_t(::sysconf(_SC_PAGESIZE));
+					for (size_t i = 0; i < bytes; i += page)
+					{
+						static_cast<volatile char*>(mem)[i] = 0;
+					}
+				}
+			}
+
+			static void unmap(void* mem, size_t bytes)
+			{
+				::munmap(mem, bytes);
+				count(counters().unmaps);
+				counters().mapped_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+			}
+		};
+#endif
+	}
+
+}
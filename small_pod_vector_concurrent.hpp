@@ -0,0 +1,218 @@
+// ml-small_pod_vector concurrent v1.01
+
+
+//                  VERSION HISTORY
+//
+//  1.00 concurrent_pod_vector
+//  1.01 segment_math shared with small_pod_vector_segmented.hpp
+
+// a multi-producer append-only collector: StaticCapacity elements inline, then a chain of heap segments
+// doubling in size, so appending never moves an element and many threads can append at once
+
+#pragma once
+
+#include "small_pod_vector_segmented.hpp"
+
+#include <atomic>
+
+namespace ml
+{
+
+	// appending (push_back, emplace_back, append) is safe from any number of threads: a slot is reserved
+	// with a single fetch_add, a missing segment is allocated by whoever needs it first (the losers of the
+	// race free theirs). reading the elements, clear() and the conversions need the appending threads to be
+	// done and synchronized with (joined, or a release/acquire handshake), size() is a snapshot meanwhile
+	template<typename T, size_t StaticCapacity = 16, class Alloc = impl::pod_allocator>
+	class concurrent_pod_vector : private impl::alloc_holder<Alloc>
+	{
+		static_assert(std::is_trivial<T>::value, "ml::concurrent_pod_vector with non-trivial type");
+
+		using math = impl::segment_math<StaticCapacity>;
+
+	public:
+		using allocator_type = Alloc;
+		using value_type = T;
+		using size_type = size_t;
+		using reference = T&;
+		using const_reference = const T&;
+
+		static constexpr size_t static_capacity = StaticCapacity;
+
+		concurrent_pod_vector()
+			: concurrent_pod_vector(Alloc())
+		{}
+
+		explicit concurrent_pod_vector(const Alloc& alloc)
+			: impl::alloc_holder<Alloc>(alloc)
+		{
+			for (auto& s : m_segments)
+			{
+				s.store(nullptr, std::memory_order_relaxed);
+			}
+		}
+
+		concurrent_pod_vector(const concurrent_pod_vector&) = delete;
+		concurrent_pod_vector& operator=(const concurrent_pod_vector&) = delete;
+
+		~concurrent_pod_vector()
+		{
+			for (size_t k = 1; k < math::max_segments; ++k)
+			{
+				if (auto p = m_segments[k].load(std::memory_order_relaxed))
+				{
+					impl::alloc_traits<Alloc>::deallocate(get_alloc(), p, sizeof(T) * math::segment_size(k));
+				}
+			}
+		}
+
+		void push_back(const_reference val)
+		{
+			const auto i = m_size.fetch_add(1, std::memory_order_relaxed);
+			*slot(i) = val;
+		}
+
+		template <typename... Args>
+		reference emplace_back(Args&&... args)
+		{
+			const auto i = m_size.fetch_add(1, std::memory_order_relaxed);
+			return *::new (static_cast<void*>(slot(i))) T(std::forward<Args>(args)...);
+		}
+
+		// appends the n elements at p as one contiguous run of indices, returns the index of the first
+		size_t append(const T* p, size_t n)
+		{
+			const auto first = m_size.fetch_add(n, std::memory_order_relaxed);
+
+			auto i = first;
+			const auto last = first + n;
+			while (i < last)
+			{
+				const auto k = math::segment_of(i);
+				const auto count = std::min(last, math::segment_begin(k) + math::segment_size(k)) - i;
+				std::memcpy(slot_in(k, i), p, count * sizeof(T));
+				p += count;
+				i += count;
+			}
+
+			return first;
+		}
+
+		size_t size() const noexcept
+		{
+			return m_size.load(std::memory_order_acquire);
+		}
+
+		bool empty() const noexcept
+		{
+			return size() == 0;
+		}
+
+		// keeps the segments for the next round
+		void clear() noexcept
+		{
+			m_size.store(0, std::memory_order_relaxed);
+		}
+
+		reference operator[](size_t i)
+		{
+			assert(i < size());
+			const auto k = math::segment_of(i);
+			return *slot_in(k, i);
+		}
+
+		const_reference operator[](size_t i) const
+		{
+			return const_cast<concurrent_pod_vector&>(*this)[i];
+		}
+
+		// calls f(const T* p, size_t n) for each segment's run of elements, in order
+		template <typename F>
+		void for_each_segment(F f) const
+		{
+			const auto s = size();
+
+			for (size_t k = 0; math::segment_begin(k) < s; ++k)
+			{
+				const auto n = std::min(s - math::segment_begin(k), math::segment_size(k));
+				f(segment_data(k), n);
+			}
+		}
+
+		// appends the elements to vec, one memcpy per segment
+		template <typename Vec>
+		void append_to(Vec& vec) const
+		{
+			auto p = vec.append_uninitialized(size());
+
+			for_each_segment([&p](const T* segment, size_t n)
+			{
+				std::memcpy(p, segment, n * sizeof(T));
+				p += n;
+			});
+		}
+
+		// the elements as a plain vector (static when they fit)
+		template <typename Vec = small_pod_vector<T, StaticCapacity, 0, Alloc>>
+		Vec to_vector() const
+		{
+			Vec vec(get_alloc());
+			vec.reserve(size());
+			append_to(vec);
+			return vec;
+		}
+
+		allocator_type get_allocator() const
+		{
+			return get_alloc();
+		}
+
+	private:
+		using impl::alloc_holder<Alloc>::get_alloc;
+
+		T* slot(size_t i)
+		{
+			return slot_in(math::segment_of(i), i);
+		}
+
+		T* slot_in(size_t k, size_t i)
+		{
+			return segment_data(k) + (i - math::segment_begin(k));
+		}
+
+		T* segment_data(size_t k) const
+		{
+			if (k == 0)
+			{
+				return const_cast<T*>(m_static_data);
+			}
+
+			auto p = m_segments[k].load(std::memory_order_acquire);
+			return p ? p : allocate_segment(k);
+		}
+
+		ML_SPV_NOINLINE T* allocate_segment(size_t k) const
+		{
+			auto& alloc = const_cast<concurrent_pod_vector&>(*this).get_alloc();
+			const auto bytes = sizeof(T) * math::segment_size(k);
+			auto p = static_cast<T*>(impl::alloc_traits<Alloc>::allocate(alloc, bytes).ptr);
+
+			T* expected = nullptr;
+			if (m_segments[k].compare_exchange_strong(expected, p, std::memory_order_acq_rel, std::memory_order_acquire))
+			{
+				return p;
+			}
+
+			// another thread got there first
+			impl::alloc_traits<Alloc>::deallocate(alloc, p, bytes);
+			return expected;
+		}
+
+		std::atomic<size_t> m_size{ 0 };
+
+		// [0] is unused, the first segment is m_static_data
+		mutable std::atomic<T*> m_segments[math::max_segments];
+
+		T m_static_data[StaticCapacity];
+	};
+
+}
@@ -0,0 +1,617 @@
+// ml-small_pod_vector flat v1.00
+
+
+//                  VERSION HISTORY
+//
+//  1.00 small_flat_set, small_flat_map
+
+// sorted vector containers for small lookup tables of trivial keys. up to StaticCapacity entries live in
+// the static buffers of small_pod_vector, so a table is one or two cache lines next to its owner instead
+// of a tree of nodes or a hash table on the heap
+//
+// the map keeps keys and values in separate vectors, a lookup only touches the keys. lookups have no
+// data dependent branches: with std::less on arithmetic keys and 8 to linear_search_limit entries the
+// position is a count of the keys less than the key, which the compiler vectorizes, otherwise a
+// branchless binary search
+//
+// building from a range appends everything, then sorts once. single inserts and erases move the tail,
+// like the vector they sit on, and invalidate iterators
+
+#pragma once
+
+#include "small_pod_vector.hpp"
+
+#include <functional>
+
+namespace ml
+{
+
+	namespace impl
+	{
+		// from one block of 8 up to this many keys a linear count beats the binary search
+		static constexpr size_t linear_search_limit = 16;
+
+		template<typename T, typename Compare>
+		struct counts_less : std::integral_constant<bool, std::is_arithmetic<T>::value && std::is_same<Compare, std::less<T>>::value>
+		{};
+
+		// the first of the n sorted keys at p not less than key, as an index
+		template<typename T, typename Compare>
+		size_t flat_lower_bound(const T* p, size_t n, const T& key, const Compare& comp, std::false_type)
+		{
+			if (n == 0) return 0;
+
+			// the answer is in [base, base + n], halved each step. a ?: here compiles to a branch that
+			// mispredicts half the time, the multiply doesn't
+			const T* base = p;
+			while (n > 1)
+			{
+				const auto half = n / 2;
+				base += size_t(comp(base[half - 1], key)) * half;
+				n -= half;
+			}
+			return size_t(base - p) + size_t(comp(*base, key));
+		}
+
+		template<typename T, typename Compare>
+		size_t flat_lower_bound(const T* p, size_t n, const T& key, const Compare& comp, std::true_type)
+		{
+			if (n >= 8 && n <= linear_search_limit)
+			{
+				// blocks of a fixed size are vectorized at -O2 too
+				size_t i = 0;
+				size_t j = 0;
+				for (; j + 8 <= n; j += 8)
+				{
+					unsigned block = 0;
+					for (size_t k = 0; k < 8; ++k)
+					{
+						block += unsigned(p[j + k] < key);
+					}
+					i += block;
+				}
+				for (; j < n; ++j)
+				{
+					i += size_t(p[j] < key);
+				}
+				return i;
+			}
+			return flat_lower_bound(p, n, key, comp, std::false_type());
+		}
+
+		template<typename T, typename Compare>
+		size_t flat_lower_bound(const T* p, size_t n, const T& key, const Compare& comp)
+		{
+			return flat_lower_bound(p, n, key, comp, counts_less<T, Compare>());
+		}
+
+		// the first of the n sorted keys at p greater than key
+		template<typename T, typename Compare>
+		size_t flat_upper_bound(const T* p, size_t n, const T& key, const Compare& comp)
+		{
+			const auto i = flat_lower_bound(p, n, key, comp);
+			return i + size_t(i < n && !comp(key, p[i]));
+		}
+
+		// a key and its value while building a map from a range
+		template<typename K, typename V>
+		struct flat_entry
+		{
+			K key;
+			V value;
+		};
+	}
+
+	template<typename T, size_t StaticCapacity = 16, class Compare = std::less<T>>
+	class small_flat_set : private Compare
+	{
+		static_assert(std::is_trivial<T>::value, "ml::small_flat_set with non-trivial type");
+
+		using vector_type = small_pod_vector<T, StaticCapacity>;
+
+	public:
+		using key_type = T;
+		using value_type = T;
+		using key_compare = Compare;
+		using size_type = size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = const T&;
+		using const_reference = const T&;
+		using pointer = const T*;
+		using const_pointer = const T*;
+		using iterator = const T*;
+		using const_iterator = const T*;
+		using reverse_iterator = std::reverse_iterator<const_iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		small_flat_set() = default;
+
+		explicit small_flat_set(const Compare& comp)
+			: Compare(comp)
+		{}
+
+		template <typename InputIterator, typename = typename std::iterator_traits<InputIterator>::iterator_category>
+		small_flat_set(InputIterator first, InputIterator last, const Compare& comp = Compare())
+			: Compare(comp)
+		{
+			insert(first, last);
+		}
+
+		small_flat_set(std::initializer_list<T> ilist, const Compare& comp = Compare())
+			: Compare(comp)
+		{
+			insert(ilist.begin(), ilist.end());
+		}
+
+		small_flat_set& operator=(std::initializer_list<T> ilist)
+		{
+			m_keys.clear();
+			insert(ilist.begin(), ilist.end());
+			return *this;
+		}
+
+		const_iterator begin() const noexcept { return m_keys.data(); }
+		const_iterator end() const noexcept { return m_keys.data() + m_keys.size(); }
+		const_iterator cbegin() const noexcept { return begin(); }
+		const_iterator cend() const noexcept { return end(); }
+		const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+		const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+		size_type size() const noexcept { return m_keys.size(); }
+		bool empty() const noexcept { return m_keys.empty(); }
+		size_type capacity() const noexcept { return m_keys.capacity(); }
+		const_pointer data() const noexcept { return m_keys.data(); }
+		key_compare key_comp() const { return *this; }
+
+		void reserve(size_type n) { m_keys.reserve(n); }
+		void shrink_to_fit() { m_keys.shrink_to_fit(); }
+		void clear() noexcept { m_keys.clear(); }
+
+		const_iterator lower_bound(const T& key) const
+		{
+			return begin() + impl::flat_lower_bound(m_keys.data(), m_keys.size(), key, comp());
+		}
+
+		const_iterator upper_bound(const T& key) const
+		{
+			return begin() + impl::flat_upper_bound(m_keys.data(), m_keys.size(), key, comp());
+		}
+
+		std::pair<const_iterator, const_iterator> equal_range(const T& key) const
+		{
+			const auto it = lower_bound(key);
+			return { it, it + ptrdiff_t(it != end() && !comp()(key, *it)) };
+		}
+
+		const_iterator find(const T& key) const
+		{
+			const auto it = lower_bound(key);
+			return it != end() && !comp()(key, *it) ? it : end();
+		}
+
+		bool contains(const T& key) const { return find(key) != end(); }
+		size_type count(const T& key) const { return contains(key) ? 1 : 0; }
+
+		std::pair<iterator, bool> insert(const T& key)
+		{
+			const auto i = impl::flat_lower_bound(m_keys.data(), m_keys.size(), key, comp());
+			if (i < m_keys.size() && !comp()(key, m_keys[i]))
+			{
+				return { begin() + i, false };
+			}
+			m_keys.insert(m_keys.cbegin() + i, key);
+			return { begin() + i, true };
+		}
+
+		// appends the range, then one sort and one pass dropping the duplicates
+		template <typename InputIterator, typename = typename std::iterator_traits<InputIterator>::iterator_category>
+		void insert(InputIterator first, InputIterator last)
+		{
+			for (; first != last; ++first)
+			{
+				m_keys.push_back(*first);
+			}
+			sort_unique();
+		}
+
+		void insert(std::initializer_list<T> ilist)
+		{
+			insert(ilist.begin(), ilist.end());
+		}
+
+		size_type erase(const T& key)
+		{
+			const auto it = find(key);
+			if (it == end()) return 0;
+			erase(it);
+			return 1;
+		}
+
+		iterator erase(const_iterator position)
+		{
+			return m_keys.erase(position);
+		}
+
+		iterator erase(const_iterator first, const_iterator last)
+		{
+			return m_keys.erase(first, last);
+		}
+
+		void swap(small_flat_set& other)
+		{
+			// small_pod_vector has no swap(), std::swap moves through the static buffers
+			std::swap(static_cast<Compare&>(*this), static_cast<Compare&>(other));
+			std::swap(m_keys, other.m_keys);
+		}
+
+	private:
+		const Compare& comp() const { return *this; }
+
+		void sort_unique()
+		{
+			std::sort(m_keys.begin(), m_keys.end(), comp());
+			const auto last = std::unique(m_keys.begin(), m_keys.end(), [this](const T& a, const T& b) { return !comp()(a, b); });
+			m_keys.erase(last, m_keys.end());
+		}
+
+		vector_type m_keys;
+	};
+
+	template<typename T, size_t StaticCapacity, class Compare>
+	bool operator==(const small_flat_set<T, StaticCapacity, Compare>& a, const small_flat_set<T, StaticCapacity, Compare>& b)
+	{
+		return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+	}
+
+	template<typename T, size_t StaticCapacity, class Compare>
+	bool operator!=(const small_flat_set<T, StaticCapacity, Compare>& a, const small_flat_set<T, StaticCapacity, Compare>& b)
+	{
+		return !(a == b);
+	}
+
+	// keys and values in two vectors (structure of arrays). iterators hand out {first, second} pairs of
+	// references made on the fly, keys() and values() the arrays themselves
+	template<typename K, typename V, size_t StaticCapacity = 16, class Compare = std::less<K>>
+	class small_flat_map : private Compare
+	{
+		static_assert(std::is_trivial<K>::value, "ml::small_flat_map with non-trivial key type");
+		static_assert(std::is_trivial<V>::value, "ml::small_flat_map with non-trivial mapped type");
+
+		using key_vector = small_pod_vector<K, StaticCapacity>;
+		using value_vector = small_pod_vector<V, StaticCapacity>;
+
+		template<bool Const>
+		class basic_iterator
+		{
+			using mapped = typename std::conditional<Const, const V, V>::type;
+
+		public:
+			struct reference
+			{
+				const K& first;
+				mapped& second;
+			};
+
+			struct pointer
+			{
+				reference ref;
+				const reference* operator->() const { return &ref; }
+			};
+
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = std::pair<K, V>;
+			using difference_type = std::ptrdiff_t;
+
+			basic_iterator() = default;
+
+			basic_iterator(const K* key, mapped* value)
+				: m_key(key)
+				, m_value(value)
+			{}
+
+			// iterator to const_iterator
+			template <bool C = Const, typename = typename std::enable_if<C>::type>
+			basic_iterator(const basic_iterator<false>& other)
+				: m_key(other.key_ptr())
+				, m_value(other.value_ptr())
+			{}
+
+			reference operator*() const { return { *m_key, *m_value }; }
+			pointer operator->() const { return { **this }; }
+			reference operator[](difference_type n) const { return *(*this + n); }
+
+			basic_iterator& operator++() { ++m_key; ++m_value; return *this; }
+			basic_iterator& operator--() { --m_key; --m_value; return *this; }
+			basic_iterator operator++(int) { auto t = *this; ++*this; return t; }
+			basic_iterator operator--(int) { auto t = *this; --*this; return t; }
+			basic_iterator& operator+=(difference_type n) { m_key += n; m_value += n; return *this; }
+			basic_iterator& operator-=(difference_type n) { m_key -= n; m_value -= n; return *this; }
+			basic_iterator operator+(difference_type n) const { return basic_iterator(m_key + n, m_value + n); }
+			basic_iterator operator-(difference_type n) const { return basic_iterator(m_key - n, m_value - n); }
+			difference_type operator-(const basic_iterator& other) const { return m_key - other.m_key; }
+
+			bool operator==(const basic_iterator& other) const { return m_key == other.m_key; }
+			bool operator!=(const basic_iterator& other) const { return m_key != other.m_key; }
+			bool operator<(const basic_iterator& other) const { return m_key < other.m_key; }
+			bool operator>(const basic_iterator& other) const { return m_key > other.m_key; }
+			bool operator<=(const basic_iterator& other) const { return m_key <= other.m_key; }
+			bool operator>=(const basic_iterator& other) const { return m_key >= other.m_key; }
+
+			const K* key_ptr() const { return m_key; }
+			mapped* value_ptr() const { return m_value; }
+
+		private:
+			const K* m_key = nullptr;
+			mapped* m_value = nullptr;
+		};
+
+	public:
+		using key_type = K;
+		using mapped_type = V;
+		using value_type = std::pair<K, V>;
+		using key_compare = Compare;
+		using size_type = size_t;
+		using difference_type = std::ptrdiff_t;
+		using iterator = basic_iterator<false>;
+		using const_iterator = basic_iterator<true>;
+
+		small_flat_map() = default;
+
+		explicit small_flat_map(const Compare& comp)
+			: Compare(comp)
+		{}
+
+		template <typename InputIterator, typename = typename std::iterator_traits<InputIterator>::iterator_category>
+		small_flat_map(InputIterator first, InputIterator last, const Compare& comp = Compare())
+			: Compare(comp)
+		{
+			insert(first, last);
+		}
+
+		small_flat_map(std::initializer_list<value_type> ilist, const Compare& comp = Compare())
+			: Compare(comp)
+		{
+			insert(ilist.begin(), ilist.end());
+		}
+
+		small_flat_map& operator=(std::initializer_list<value_type> ilist)
+		{
+			clear();
+			insert(ilist.begin(), ilist.end());
+			return *this;
+		}
+
+		iterator begin() noexcept { return iterator(m_keys.data(), m_values.data()); }
+		iterator end() noexcept { return begin() + difference_type(size()); }
+		const_iterator begin() const noexcept { return const_iterator(m_keys.data(), m_values.data()); }
+		const_iterator end() const noexcept { return begin() + difference_type(size()); }
+		const_iterator cbegin() const noexcept { return begin(); }
+		const_iterator cend() const noexcept { return end(); }
+
+		size_type size() const noexcept { return m_keys.size(); }
+		bool empty() const noexcept { return m_keys.empty(); }
+		size_type capacity() const noexcept { return m_keys.capacity(); }
+		key_compare key_comp() const { return *this; }
+
+		// the sorted keys and their values, size() each
+		const K* keys() const noexcept { return m_keys.data(); }
+		V* values() noexcept { return m_values.data(); }
+		const V* values() const noexcept { return m_values.data(); }
+
+		void reserve(size_type n)
+		{
+			m_keys.reserve(n);
+			m_values.reserve(n);
+		}
+
+		void shrink_to_fit()
+		{
+			m_keys.shrink_to_fit();
+			m_values.shrink_to_fit();
+		}
+
+		void clear() noexcept
+		{
+			m_keys.clear();
+			m_values.clear();
+		}
+
+		iterator lower_bound(const K& key) { return begin() + difference_type(index_of(key)); }
+		const_iterator lower_bound(const K& key) const { return begin() + difference_type(index_of(key)); }
+
+		iterator upper_bound(const K& key)
+		{
+			return begin() + difference_type(impl::flat_upper_bound(m_keys.data(), m_keys.size(), key, comp()));
+		}
+
+		const_iterator upper_bound(const K& key) const
+		{
+			return begin() + difference_type(impl::flat_upper_bound(m_keys.data(), m_keys.size(), key, comp()));
+		}
+
+		iterator find(const K& key)
+		{
+			const auto i = index_of(key);
+			return found(i, key) ? begin() + difference_type(i) : end();
+		}
+
+		const_iterator find(const K& key) const
+		{
+			const auto i = index_of(key);
+			return found(i, key) ? begin() + difference_type(i) : end();
+		}
+
+		bool contains(const K& key) const { return found(index_of(key), key); }
+		size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+
+		// the value of key, nullptr when it's not there
+		V* get(const K& key)
+		{
+			const auto i = index_of(key);
+			return found(i, key) ? m_values.data() + i : nullptr;
+		}
+
+		const V* get(const K& key) const
+		{
+			const auto i = index_of(key);
+			return found(i, key) ? m_values.data() + i : nullptr;
+		}
+
+		// key must be there
+		V& at(const K& key)
+		{
+			const auto p = get(key);
+			assert(p);
+			return *p;
+		}
+
+		const V& at(const K& key) const
+		{
+			const auto p = get(key);
+			assert(p);
+			return *p;
+		}
+
+		// the value of key, value initialized when it's new
+		V& operator[](const K& key)
+		{
+			return *try_emplace(key, V()).first.value_ptr();
+		}
+
+		// adds key with value unless key is there
+		std::pair<iterator, bool> try_emplace(const K& key, const V& value)
+		{
+			const auto i = index_of(key);
+			if (found(i, key))
+			{
+				return { begin() + difference_type(i), false };
+			}
+			insert_at(i, key, value);
+			return { begin() + difference_type(i), true };
+		}
+
+		std::pair<iterator, bool> insert(const value_type& kv)
+		{
+			return try_emplace(kv.first, kv.second);
+		}
+
+		std::pair<iterator, bool> insert_or_assign(const K& key, const V& value)
+		{
+			const auto i = index_of(key);
+			if (found(i, key))
+			{
+				m_values[i] = value;
+				return { begin() + difference_type(i), false };
+			}
+			insert_at(i, key, value);
+			return { begin() + difference_type(i), true };
+		}
+
+		// the range (of pairs) is gathered behind the current entries, sorted once and merged back.
+		// like std::map, a key that is already there, or repeats in the range, keeps its first value
+		template <typename InputIterator, typename = typename std::iterator_traits<InputIterator>::iterator_category>
+		void insert(InputIterator first, InputIterator last)
+		{
+			using entry = impl::flat_entry<K, V>;
+
+			const auto s = size();
+			small_pod_vector<entry, StaticCapacity> entries;
+			entries.reserve(s);
+			for (size_t i = 0; i < s; ++i)
+			{
+				entries.push_back({ m_keys[i], m_values[i] });
+			}
+			for (; first != last; ++first)
+			{
+				entries.push_back({ (*first).first, (*first).second });
+			}
+
+			std::stable_sort(entries.begin(), entries.end(), [this](const entry& a, const entry& b) { return comp()(a.key, b.key); });
+			const auto end = std::unique(entries.begin(), entries.end(), [this](const entry& a, const entry& b) { return !comp()(a.key, b.key); });
+			const auto n = size_t(end - entries.begin());
+
+			const auto keys = m_keys.append_uninitialized(n - s) - s;
+			const auto values = m_values.append_uninitialized(n - s) - s;
+			for (size_t i = 0; i < n; ++i)
+			{
+				keys[i] = entries[i].key;
+				values[i] = entries[i].value;
+			}
+		}
+
+		void insert(std::initializer_list<value_type> ilist)
+		{
+			insert(ilist.begin(), ilist.end());
+		}
+
+		size_type erase(const K& key)
+		{
+			const auto i = index_of(key);
+			if (!found(i, key)) return 0;
+			erase_at(i, i + 1);
+			return 1;
+		}
+
+		iterator erase(const_iterator position)
+		{
+			const auto i = size_t(position - cbegin());
+			erase_at(i, i + 1);
+			return begin() + difference_type(i);
+		}
+
+		iterator erase(const_iterator first, const_iterator last)
+		{
+			const auto i = size_t(first - cbegin());
+			erase_at(i, size_t(last - cbegin()));
+			return begin() + difference_type(i);
+		}
+
+		void swap(small_flat_map& other)
+		{
+			std::swap(static_cast<Compare&>(*this), static_cast<Compare&>(other));
+			std::swap(m_keys, other.m_keys);
+			std::swap(m_values, other.m_values);
+		}
+
+	private:
+		const Compare& comp() const { return *this; }
+
+		size_t index_of(const K& key) const
+		{
+			return impl::flat_lower_bound(m_keys.data(), m_keys.size(), key, comp());
+		}
+
+		bool found(size_t i, const K& key) const
+		{
+			return i < m_keys.size() && !comp()(key, m_keys[i]);
+		}
+
+		void insert_at(size_t i, const K& key, const V& value)
+		{
+			m_keys.insert(m_keys.cbegin() + i, key);
+			m_values.insert(m_values.cbegin() + i, value);
+		}
+
+		void erase_at(size_t first, size_t last)
+		{
+			m_keys.erase(m_keys.cbegin() + first, m_keys.cbegin() + last);
+			m_values.erase(m_values.cbegin() + first, m_values.cbegin() + last);
+		}
+
+		key_vector m_keys;
+		value_vector m_values;
+	};
+
+	template<typename K, typename V, size_t StaticCapacity, class Compare>
+	bool operator==(const small_flat_map<K, V, StaticCapacity, Compare>& a, const small_flat_map<K, V, StaticCapacity, Compare>& b)
+	{
+		return a.size() == b.size() && std::equal(a.keys(), a.keys() + a.size(), b.keys()) && std::equal(a.values(), a.values() + a.size(), b.values());
+	}
+
+	template<typename K, typename V, size_t StaticCapacity, class Compare>
+	bool operator!=(const small_flat_map<K, V, StaticCapacity, Compare>& a, const small_flat_map<K, V, StaticCapacity, Compare>& b)
+	{
+		return !(a == b);
+	}
+
+}
@@ -0,0 +1,276 @@
+// ml-small_pod_vector io v1.01
+
+
+//                  VERSION HISTORY
+//
+//  1.00 tail/commit, read/readv/pread/recvmsg into the tail, writev of many vectors
+//  1.01 tail() makes the room writable and commit() keeps it below RevertToStaticSize too
+
+// scatter/gather I/O straight into and out of vectors (posix). reads reserve room at the end of the
+// vector (in the static buffer when it fits), point an iovec at it and grow the vector by what arrived,
+// with no buffer in between. writes gather many vectors into one writev
+//
+// sizes are in elements, the return values in bytes or -1 with errno set, like the calls they wrap.
+// EINTR is retried. a read ending inside an element keeps reading until the element is whole, unless
+// the end of the file comes first, then the partial element is dropped
+
+#pragma once
+
+#include "small_pod_vector.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cerrno>
+#include <climits>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace ml
+{
+
+	namespace io
+	{
+		// room for n more elements at the end of vec, as an iovec. nothing is added until commit()
+		// reserve() isn't enough: below RevertToStaticSize it leaves capacity() where it was
+		template<typename Vec>
+		iovec tail(Vec& vec, size_t n)
+		{
+			vec.reserve_writable(vec.size() + n);
+			assert(vec.capacity() >= vec.size() + n);
+			return { static_cast<void*>(vec.data() + vec.size()), n * sizeof(*vec.data()) };
+		}
+
+		// grows vec by the whole elements of bytes written into its tail
+		template<typename Vec>
+		void commit(Vec& vec, size_t bytes)
+		{
+			const auto n = bytes / sizeof(*vec.data());
+			vec.commit_uninitialized(n);
+		}
+
+		namespace impl
+		{
+			// calls f until it doesn't fail with EINTR
+			template<typename F>
+			ssize_t retry(F f)
+			{
+				ssize_t r;
+				do
+				{
+					r = f();
+				} while (r < 0 && errno == EINTR);
+				return r;
+			}
+
+			// reads the rest of a partial element of element_size bytes, got of which are at p
+			// next(p, n) reads up to n bytes to p. returns the bytes added, -1 on an error
+			template<typename F>
+			ssize_t complete_element(unsigned char* p, size_t got, size_t element_size, F next)
+			{
+				const auto start = got;
+				while (got < element_size)
+				{
+					const auto r = retry([&]() { return next(p + got, element_size - got); });
+					if (r < 0) return -1;
+					if (r == 0) break;
+					got += size_t(r);
+				}
+				return ssize_t(got - start);
+			}
+
+			// the bytes of a read of total bytes into iovs, whole elements only
+			template<typename Vec>
+			void commit_scattered(Vec* const* vecs, const iovec* iovs, size_t count, size_t total)
+			{
+				for (size_t i = 0; i < count && total; ++i)
+				{
+					const auto bytes = total < iovs[i].iov_len ? total : iovs[i].iov_len;
+					commit(*vecs[i], bytes);
+					total -= bytes;
+				}
+			}
+		}
+
+		// read(2) of up to max elements onto the end of vec
+		template<typename Vec>
+		ssize_t read_append(int fd, Vec& vec, size_t max)
+		{
+			const auto iov = tail(vec, max);
+			const auto p = static_cast<unsigned char*>(iov.iov_base);
+			const size_t element_size = sizeof(*vec.data());
+
+			auto r = impl::retry([&]() { return ::read(fd, p, iov.iov_len); });
+			if (r <= 0) return r;
+
+			if (const auto partial = size_t(r) % element_size)
+			{
+				const auto more = impl::complete_element(p + size_t(r) - partial, partial, element_size, [fd](unsigned char* to, size_t n) { return ::read(fd, to, n); });
+				if (more < 0) return -1;
+				r += more;
+			}
+
+			commit(vec, size_t(r));
+			return r;
+		}
+
+		// pread(2) of up to max elements from offset onto the end of vec
+		template<typename Vec>
+		ssize_t pread_append(int fd, Vec& vec, size_t max, off_t offset)
+		{
+			const auto iov = tail(vec, max);
+			const auto p = static_cast<unsigned char*>(iov.iov_base);
+			const size_t element_size = sizeof(*vec.data());
+
+			auto r = impl::retry([&]() { return ::pread(fd, p, iov.iov_len, offset); });
+			if (r <= 0) return r;
+
+			if (const auto partial = size_t(r) % element_size)
+			{
+				auto at = offset + off_t(r);
+				const auto more = impl::complete_element(p + size_t(r) - partial, partial, element_size, [fd, &at](unsigned char* to, size_t n)
+				{
+					const auto got = ::pread(fd, to, n, at);
+					if (got > 0) at += off_t(got);
+					return got;
+				});
+				if (more < 0) return -1;
+				r += more;
+			}
+
+			commit(vec, size_t(r));
+			return r;
+		}
+
+		// one readv(2) scattering into the tails of count vectors, up to max elements each, in order.
+		// a short read fills the first ones. count is at most IOV_MAX
+		template<typename Vec>
+		ssize_t readv_append(int fd, Vec* const* vecs, size_t count, size_t max)
+		{
+			assert(count <= IOV_MAX);
+
+			iovec iovs[IOV_MAX];
+			for (size_t i = 0; i < count; ++i)
+			{
+				iovs[i] = tail(*vecs[i], max);
+			}
+
+			auto r = impl::retry([&]() { return ::readv(fd, iovs, int(count)); });
+			if (r <= 0) return r;
+
+			const size_t element_size = sizeof(*vecs[0]->data());
+			if (const auto partial = size_t(r) % element_size)
+			{
+				// iovecs hold whole elements, so the rest of it fits where the read ended
+				size_t i = 0;
+				auto in_last = size_t(r);
+				while (in_last > iovs[i].iov_len)
+				{
+					in_last -= iovs[i].iov_len;
+					++i;
+				}
+
+				const auto more = impl::complete_element(static_cast<unsigned char*>(iovs[i].iov_base) + in_last - partial, partial, element_size, [fd](unsigned char* to, size_t n) { return ::read(fd, to, n); });
+				if (more < 0) return -1;
+				r += more;
+			}
+
+			impl::commit_scattered(vecs, iovs, count, size_t(r));
+			return r;
+		}
+
+		// recvmsg(2) of up to max elements onto the end of vec. msg, when given, supplies the name and
+		// control buffers and gets the flags back, its iovec is replaced. a datagram's partial element is
+		// dropped (MSG_TRUNC tells a truncated one), a stream's is completed
+		template<typename Vec>
+		ssize_t recvmsg_append(int fd, Vec& vec, size_t max, int flags = 0, msghdr* msg = nullptr)
+		{
+			auto iov = tail(vec, max);
+			const auto p = static_cast<unsigned char*>(iov.iov_base);
+			const size_t element_size = sizeof(*vec.data());
+
+			msghdr local = {};
+			auto& m = msg ? *msg : local;
+			m.msg_iov = &iov;
+			m.msg_iovlen = 1;
+
+			auto r = impl::retry([&]() { return ::recvmsg(fd, &m, flags); });
+			if (r <= 0) return r;
+
+			int type = 0;
+			socklen_t length = sizeof(type);
+			const auto partial = size_t(r) % element_size;
+			if (partial && ::getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &length) == 0 && type == SOCK_STREAM)
+			{
+				const auto more = impl::complete_element(p + size_t(r) - partial, partial, element_size, [fd, flags](unsigned char* to, size_t n) { return ::recv(fd, to, n, flags); });
+				if (more < 0) return -1;
+				r += more;
+			}
+
+			m.msg_iov = nullptr;
+			m.msg_iovlen = 0;
+
+			commit(vec, size_t(r));
+			return r;
+		}
+
+		// writes the vectors in [first, last) (anything with data() and size()) in as few writev(2)
+		// calls as IOV_MAX allows, continuing after short writes. returns the bytes written
+		template<typename Iterator>
+		ssize_t writev_all(int fd, Iterator first, Iterator last)
+		{
+			iovec iovs[IOV_MAX];
+			size_t written = 0;
+
+			while (first != last)
+			{
+				int count = 0;
+				for (; first != last && count < IOV_MAX; ++first)
+				{
+					const auto& v = *first;
+					if (v.size())
+					{
+						iovs[count++] = { const_cast<void*>(static_cast<const void*>(v.data())), v.size() * sizeof(*v.data()) };
+					}
+				}
+
+				auto iov = iovs;
+				while (count)
+				{
+					const auto r = impl::retry([&]() { return ::writev(fd, iov, count); });
+					if (r < 0) return -1;
+
+					written += size_t(r);
+
+					// skip what went out, the rest goes again
+					auto done = size_t(r);
+					while (count && done >= iov->iov_len)
+					{
+						done -= iov->iov_len;
+						++iov;
+						--count;
+					}
+					if (count)
+					{
+						iov->iov_base = static_cast<unsigned char*>(iov->iov_base) + done;
+						iov->iov_len -= done;
+					}
+				}
+			}
+
+			return ssize_t(written);
+		}
+
+		template<typename Range>
+		ssize_t writev_all(int fd, const Range& vecs)
+		{
+			using std::begin;
+			using std::end;
+			return writev_all(fd, begin(vecs), end(vecs));
+		}
+	}
+
+}
+
+#endif
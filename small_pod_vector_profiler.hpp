@@ -0,0 +1,249 @@
+// ml-small_pod_vector profiler v1.00
+
+
+//                  VERSION HISTORY
+//
+//  1.00 per call site peak size profile and StaticCapacity recommendation
+
+// finds the StaticCapacity each call site needs. declare the vectors as
+//
+//	ML_SPV_PROFILE_SITE(token_site);
+//	ml::profile::profiled_vector<token, 16, token_site> tokens;
+//
+// and build with ML_SPV_PROFILE defined: every vector records its peak size under its site, and
+// ml::profile::dump(ml::profile::report()) lists the size distribution and the recommended capacity per site.
+// without ML_SPV_PROFILE a profiled_vector is a plain small_pod_vector
+
+#pragma once
+
+#include "small_pod_vector_stats.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+#define ML_SPV_PROFILE_STRINGIFY_(x) #x
+#define ML_SPV_PROFILE_STRINGIFY(x) ML_SPV_PROFILE_STRINGIFY_(x)
+
+// a tag type naming a call site, with where it was declared
+#define ML_SPV_PROFILE_SITE(NAME) \
+	struct NAME { static const char* name() { return #NAME " (" __FILE__ ":" ML_SPV_PROFILE_STRINGIFY(__LINE__) ")"; } }
+
+namespace ml
+{
+
+	namespace profile
+	{
+		// exact peak sizes are kept up to this, larger ones are counted together
+		static constexpr size_t max_tracked_size = 1024;
+
+		namespace impl
+		{
+			// one per site, never destroyed since vectors may die during static destruction
+			struct site_entry
+			{
+				const char* name;
+				size_t element_size;
+				size_t static_capacity;
+				stats::statistics (*snapshot)();
+
+				// [i] vectors whose peak size was i, the last one everything larger
+				std::atomic<uint64_t> peaks[max_tracked_size + 2];
+
+				site_entry* next;
+
+				void record(size_t peak)
+				{
+					peaks[peak < max_tracked_size + 1 ? peak : max_tracked_size + 1].fetch_add(1, std::memory_order_relaxed);
+				}
+			};
+
+			struct site_registry
+			{
+				std::mutex mutex;
+				site_entry* all = nullptr;
+			};
+
+			inline site_registry& get_site_registry()
+			{
+				static site_registry* r = new site_registry;
+				return *r;
+			}
+		}
+
+		// a StatsPolicy counting like stats::counting and recording every vector's peak size under Site,
+		// a type with a static const char* name() (see ML_SPV_PROFILE_SITE)
+		template<typename Site, size_t ElementSize, size_t StaticCapacity>
+		class site : public stats::counting<Site>
+		{
+		public:
+			site()
+			{
+				entry();
+			}
+
+			~site()
+			{
+				if (const auto p = this->peak())
+				{
+					entry().record(p);
+				}
+			}
+
+		private:
+			static impl::site_entry& entry()
+			{
+				static impl::site_entry* e = make_entry();
+				return *e;
+			}
+
+			static impl::site_entry* make_entry()
+			{
+				// value initialized, so the counts start at zero
+				auto e = new impl::site_entry();
+				e->name = Site::name();
+				e->element_size = ElementSize;
+				e->static_capacity = StaticCapacity;
+				e->snapshot = &stats::counting<Site>::snapshot;
+
+				auto& r = impl::get_site_registry();
+				std::lock_guard<std::mutex> lock(r.mutex);
+				e->next = r.all;
+				r.all = e;
+				return e;
+			}
+		};
+
+#ifdef ML_SPV_PROFILE
+		template<typename T, size_t StaticCapacity, typename Site, size_t RevertToStaticSize = 0, class Alloc = ml::impl::pod_allocator, class GrowthPolicy = growth::tight_spill, class Layout = layout::pointers, class RetentionPolicy = retention::keep>
+		using profiled_vector = small_pod_vector<T, StaticCapacity, RevertToStaticSize, Alloc, GrowthPolicy, Layout, RetentionPolicy, site<Site, sizeof(T), StaticCapacity>>;
+#else
+		template<typename T, size_t StaticCapacity, typename Site, size_t RevertToStaticSize = 0, class Alloc = ml::impl::pod_allocator, class GrowthPolicy = growth::tight_spill, class Layout = layout::pointers, class RetentionPolicy = retention::keep>
+		using profiled_vector = small_pod_vector<T, StaticCapacity, RevertToStaticSize, Alloc, GrowthPolicy, Layout, RetentionPolicy>;
+#endif
+
+		struct options
+		{
+			// the most static buffer bytes a recommendation may use per vector
+			size_t inline_budget_bytes = 256;
+
+			// the recommendation is the smallest capacity spilling at most this fraction of the vectors
+			double max_spill_rate = 0.05;
+		};
+
+		struct site_report
+		{
+			const char* name;
+			size_t element_size;
+			size_t static_capacity;
+			stats::statistics stats;
+
+			uint64_t vectors;				// destroyed vectors that held elements
+			std::vector<uint64_t> peaks;	// [i] vectors whose peak size was i, the last one everything above max_tracked_size
+
+			double spill_rate;				// of the vectors, the fraction that outgrew static_capacity
+			size_t recommended_capacity;
+			double recommended_spill_rate;
+
+			// the fraction of the vectors whose peak was above capacity
+			double spill_rate_at(size_t capacity) const
+			{
+				if (!vectors) return 0;
+
+				uint64_t spilled = 0;
+				for (size_t i = capacity + 1; i < peaks.size(); ++i)
+				{
+					spilled += peaks[i];
+				}
+				return double(spilled) / double(vectors);
+			}
+
+			// the smallest peak size that fraction of the vectors stays within
+			size_t percentile(double fraction) const
+			{
+				uint64_t within = 0;
+				for (size_t i = 0; i < peaks.size(); ++i)
+				{
+					within += peaks[i];
+					if (double(within) >= fraction * double(vectors))
+					{
+						return i;
+					}
+				}
+				return peaks.size() - 1;
+			}
+		};
+
+		// every site with a vector constructed so far, the recommendation minimizing spills within the budget
+		inline std::vector<site_report> report(const options& o = options())
+		{
+			std::vector<site_report> reports;
+
+			auto& r = impl::get_site_registry();
+			std::lock_guard<std::mutex> lock(r.mutex);
+
+			for (auto e = r.all; e; e = e->next)
+			{
+				site_report s;
+				s.name = e->name;
+				s.element_size = e->element_size;
+				s.static_capacity = e->static_capacity;
+				s.stats = e->snapshot();
+				s.vectors = 0;
+
+				s.peaks.resize(max_tracked_size + 2);
+				for (size_t i = 0; i < s.peaks.size(); ++i)
+				{
+					s.peaks[i] = e->peaks[i].load(std::memory_order_relaxed);
+					s.vectors += s.peaks[i];
+				}
+
+				s.spill_rate = s.spill_rate_at(s.static_capacity);
+
+				const size_t budget = std::max<size_t>(1, o.inline_budget_bytes / s.element_size);
+				if (s.vectors)
+				{
+					// spills only go down as the capacity grows, so the first one under the rate is the smallest
+					size_t capacity = 1;
+					while (capacity < budget && capacity <= max_tracked_size && s.spill_rate_at(capacity) > o.max_spill_rate)
+					{
+						++capacity;
+					}
+					s.recommended_capacity = capacity;
+				}
+				else
+				{
+					s.recommended_capacity = s.static_capacity;
+				}
+				s.recommended_spill_rate = s.spill_rate_at(s.recommended_capacity);
+
+				reports.push_back(std::move(s));
+			}
+
+			return reports;
+		}
+
+		// one block per site
+		inline void dump(const std::vector<site_report>& reports, std::FILE* out = stderr)
+		{
+			for (const auto& s : reports)
+			{
+				std::fprintf(out, "%s\n", s.name);
+				std::fprintf(out, "  element size %zu, static capacity %zu, %llu vectors, %llu spills, %llu bytes allocated\n",
+					s.element_size, s.static_capacity, (unsigned long long)s.vectors, (unsigned long long)s.stats.spills, (unsigned long long)s.stats.bytes_allocated);
+
+				if (s.vectors)
+				{
+					std::fprintf(out, "  peak size p50 %zu, p90 %zu, p99 %zu, max %zu%s\n",
+						s.percentile(0.5), s.percentile(0.9), s.percentile(0.99), s.percentile(1.0), s.peaks.back() ? "+" : "");
+				}
+
+				std::fprintf(out, "  spill rate %.1f%% at %zu, recommended static capacity %zu (%zu bytes, spill rate %.1f%%)\n",
+					100 * s.spill_rate, s.static_capacity, s.recommended_capacity, s.recommended_capacity * s.element_size, 100 * s.recommended_spill_rate);
+			}
+		}
+	}
+
+}
@@ -0,0 +1,535 @@
+// ml-small_pod_vector segmented v1.00
+
+
+//                  VERSION HISTORY
+//
+//  1.00 segmented_pod_vector
+
+// a vector that never copies on growth: StaticCapacity elements inline, then heap segments doubling in size.
+// appending never moves an element, so pointers and references stay valid, and growing needs no second
+// buffer next to the first. the price is that the elements aren't contiguous, to_vector() flattens them
+
+#pragma once
+
+#include "small_pod_vector.hpp"
+
+#include <climits>
+
+namespace ml
+{
+
+	namespace impl
+	{
+		// element i of a chain of segments where segment 0 holds First elements and segment k > 0
+		// holds First << (k - 1), so segment k starts at First << (k - 1) too
+		template<size_t First>
+		struct segment_math
+		{
+			static_assert(First > 0, "ml::impl::segment_math: the first segment must not be empty");
+
+			// enough segments to index every size_t
+			static constexpr size_t max_segments = sizeof(size_t) * CHAR_BIT + 1;
+
+			static size_t segment_of(size_t i)
+			{
+				if (i < First) return 0;
+				return bit_width(i / First);
+			}
+
+			static size_t segment_begin(size_t k)
+			{
+				return k == 0 ? 0 : First << (k - 1);
+			}
+
+			static size_t segment_size(size_t k)
+			{
+				return k == 0 ? First : First << (k - 1);
+			}
+
+			// the number of bits needed to hold n > 0
+			static size_t bit_width(size_t n)
+			{
+#if defined(__GNUC__)
+				return size_t(sizeof(unsigned long long) * CHAR_BIT - __builtin_clzll((unsigned long long)n));
+#else
+				size_t w = 0;
+				while (n)
+				{
+					n >>= 1;
+					++w;
+				}
+				return w;
+#endif
+			}
+		};
+	}
+
+	template<typename T, size_t StaticCapacity = 16, class Alloc = impl::pod_allocator>
+	class segmented_pod_vector : private impl::alloc_holder<Alloc>
+	{
+		static_assert(std::is_trivial<T>::value, "ml::segmented_pod_vector with non-trivial type");
+
+		using math = impl::segment_math<StaticCapacity>;
+
+		template <bool Const>
+		class basic_iterator;
+
+	public:
+		using allocator_type = Alloc;
+		using value_type = T;
+		using size_type = size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = T&;
+		using const_reference = const T&;
+		using pointer = T*;
+		using const_pointer = const T*;
+		using iterator = basic_iterator<false>;
+		using const_iterator = basic_iterator<true>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		static constexpr size_t static_capacity = StaticCapacity;
+
+		segmented_pod_vector()
+			: segmented_pod_vector(Alloc())
+		{}
+
+		explicit segmented_pod_vector(const Alloc& alloc)
+			: impl::alloc_holder<Alloc>(alloc)
+		{
+			m_segments[0] = m_static_data;
+			m_end = m_static_data;
+			m_segment_end = m_static_data + StaticCapacity;
+		}
+
+		segmented_pod_vector(std::initializer_list<T> l, const Alloc& alloc = Alloc())
+			: segmented_pod_vector(alloc)
+		{
+			append(l.begin(), l.size());
+		}
+
+		segmented_pod_vector(const segmented_pod_vector& v)
+			: segmented_pod_vector(v.get_alloc())
+		{
+			reserve(v.size());
+			v.for_each_segment([this](const T* p, size_t n) { append(p, n); });
+		}
+
+		// the heap segments are taken over, the inline elements are copied
+		segmented_pod_vector(segmented_pod_vector&& v)
+			: segmented_pod_vector(std::move(v.get_alloc()))
+		{
+			take(v);
+		}
+
+		~segmented_pod_vector()
+		{
+			free_segments(1);
+		}
+
+		segmented_pod_vector& operator=(const segmented_pod_vector& v)
+		{
+			if (this != &v)
+			{
+				clear();
+				reserve(v.size());
+				v.for_each_segment([this](const T* p, size_t n) { append(p, n); });
+			}
+			return *this;
+		}
+
+		segmented_pod_vector& operator=(segmented_pod_vector&& v)
+		{
+			if (this != &v)
+			{
+				free_segments(1);
+				get_alloc() = std::move(v.get_alloc());
+				take(v);
+			}
+			return *this;
+		}
+
+		allocator_type get_allocator() const
+		{
+			return get_alloc();
+		}
+
+		size_t size() const noexcept
+		{
+			return m_size;
+		}
+
+		bool empty() const noexcept
+		{
+			return m_size == 0;
+		}
+
+		// the elements the allocated segments hold
+		size_t capacity() const noexcept
+		{
+			return math::segment_begin(m_allocated);
+		}
+
+		size_type max_size() const noexcept
+		{
+			return size_t(-1) / sizeof(T);
+		}
+
+		reference operator[](size_t i)
+		{
+			assert(i < m_size);
+			const auto k = math::segment_of(i);
+			return m_segments[k][i - math::segment_begin(k)];
+		}
+
+		const_reference operator[](size_t i) const
+		{
+			return const_cast<segmented_pod_vector&>(*this)[i];
+		}
+
+		const_reference at(size_type i) const
+		{
+			assert(i < size());
+			return (*this)[i];
+		}
+
+		reference at(size_type i)
+		{
+			assert(i < size());
+			return (*this)[i];
+		}
+
+		const_reference front() const
+		{
+			assert(!empty());
+			return m_static_data[0];
+		}
+
+		reference front()
+		{
+			assert(!empty());
+			return m_static_data[0];
+		}
+
+		const_reference back() const
+		{
+			assert(!empty());
+			return m_end[-1];
+		}
+
+		reference back()
+		{
+			assert(!empty());
+			return m_end[-1];
+		}
+
+		iterator begin() noexcept { return iterator(this, 0); }
+		const_iterator begin() const noexcept { return const_iterator(this, 0); }
+		const_iterator cbegin() const noexcept { return begin(); }
+		iterator end() noexcept { return iterator(this, m_size); }
+		const_iterator end() const noexcept { return const_iterator(this, m_size); }
+		const_iterator cend() const noexcept { return end(); }
+		reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+		reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+		void push_back(const_reference val)
+		{
+			emplace_back(val);
+		}
+
+		template <typename... Args>
+		reference emplace_back(Args&&... args)
+		{
+			if (ML_SPV_LIKELY(m_end != m_segment_end))
+			{
+				auto p = ::new (static_cast<void*>(m_end)) T(std::forward<Args>(args)...);
+				++m_end;
+				++m_size;
+				return *p;
+			}
+
+			// the value may be an element, but those don't move
+			next_segment();
+			return emplace_back(std::forward<Args>(args)...);
+		}
+
+		void pop_back()
+		{
+			assert(!empty());
+			set_size(m_size - 1);
+		}
+
+		// appends the n elements at p, one memcpy per segment touched
+		void append(const T* p, size_t n)
+		{
+			reserve(m_size + n);
+
+			while (n)
+			{
+				if (m_end == m_segment_end)
+				{
+					next_segment();
+				}
+
+				const auto count = std::min(n, size_t(m_segment_end - m_end));
+				std::memcpy(m_end, p, count * sizeof(T));
+				m_end += count;
+				m_size += count;
+				p += count;
+				n -= count;
+			}
+		}
+
+		// allocates the segments to hold new_cap elements, nothing moves
+		void reserve(size_type new_cap)
+		{
+			assert(new_cap <= max_size());
+
+			while (capacity() < new_cap)
+			{
+				allocate_segment(m_allocated);
+			}
+		}
+
+		// the new elements are uninitialized
+		void resize(size_type n)
+		{
+			reserve(n);
+			set_size(n);
+		}
+
+		void resize(size_type n, const value_type& value)
+		{
+			const auto s = m_size;
+			resize(n);
+
+			for (auto k = math::segment_of(s); s < n && math::segment_begin(k) < n; ++k)
+			{
+				const auto first = std::max(s, math::segment_begin(k));
+				const auto last = std::min(n, math::segment_begin(k) + math::segment_size(k));
+				std::fill(m_segments[k] + (first - math::segment_begin(k)), m_segments[k] + (last - math::segment_begin(k)), value);
+			}
+		}
+
+		// keeps the segments
+		void clear() noexcept
+		{
+			set_size(0);
+		}
+
+		// frees the segments beyond the ones holding elements
+		void shrink_to_fit()
+		{
+			const auto needed = m_size <= StaticCapacity ? 1 : math::segment_of(m_size - 1) + 1;
+			free_segments(needed);
+		}
+
+		// calls f(const T* p, size_t n) for each segment's run of elements, in order
+		template <typename F>
+		void for_each_segment(F f) const
+		{
+			for (size_t k = 0; math::segment_begin(k) < m_size; ++k)
+			{
+				f(m_segments[k], std::min(m_size - math::segment_begin(k), math::segment_size(k)));
+			}
+		}
+
+		// flattens the elements onto the end of vec, one memcpy per segment
+		template <typename Vec>
+		void append_to(Vec& vec) const
+		{
+			auto p = vec.append_uninitialized(size());
+
+			for_each_segment([&p](const T* segment, size_t n)
+			{
+				std::memcpy(p, segment, n * sizeof(T));
+				p += n;
+			});
+		}
+
+		// the elements as a contiguous vector
+		template <typename Vec = small_pod_vector<T, StaticCapacity, 0, Alloc>>
+		Vec to_vector() const
+		{
+			Vec vec(get_alloc());
+			vec.reserve(size());
+			append_to(vec);
+			return vec;
+		}
+
+	private:
+		using impl::alloc_holder<Alloc>::get_alloc;
+
+		// random access over the segments, walking within a segment is a pointer increment
+		template <bool Const>
+		class basic_iterator
+		{
+			using vector_type = typename std::conditional<Const, const segmented_pod_vector, segmented_pod_vector>::type;
+
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = typename std::conditional<Const, const T*, T*>::type;
+			using reference = typename std::conditional<Const, const T&, T&>::type;
+
+			basic_iterator() = default;
+
+			basic_iterator(vector_type* v, size_t i)
+				: m_vec(v)
+			{
+				seek(i);
+			}
+
+			// iterator to const_iterator
+			template <bool C = Const, typename = typename std::enable_if<C>::type>
+			basic_iterator(const basic_iterator<false>& it)
+				: basic_iterator(it.m_vec, it.m_index)
+			{}
+
+			reference operator*() const { return *m_ptr; }
+			pointer operator->() const { return m_ptr; }
+			reference operator[](difference_type n) const { return *(*this + n); }
+
+			basic_iterator& operator++()
+			{
+				++m_index;
+				if (++m_ptr == m_segment_end)
+				{
+					seek(m_index);
+				}
+				return *this;
+			}
+
+			basic_iterator operator++(int) { auto it = *this; ++*this; return it; }
+
+			basic_iterator& operator--()
+			{
+				seek(m_index - 1);
+				return *this;
+			}
+
+			basic_iterator operator--(int) { auto it = *this; --*this; return it; }
+
+			basic_iterator& operator+=(difference_type n) { seek(size_t(difference_type(m_index) + n)); return *this; }
+			basic_iterator& operator-=(difference_type n) { return *this += -n; }
+
+			friend basic_iterator operator+(basic_iterator it, difference_type n) { return it += n; }
+			friend basic_iterator operator+(difference_type n, basic_iterator it) { return it += n; }
+			friend basic_iterator operator-(basic_iterator it, difference_type n) { return it -= n; }
+			friend difference_type operator-(const basic_iterator& a, const basic_iterator& b) { return difference_type(a.m_index) - difference_type(b.m_index); }
+
+			friend bool operator==(const basic_iterator& a, const basic_iterator& b) { return a.m_index == b.m_index; }
+			friend bool operator!=(const basic_iterator& a, const basic_iterator& b) { return a.m_index != b.m_index; }
+			friend bool operator<(const basic_iterator& a, const basic_iterator& b) { return a.m_index < b.m_index; }
+			friend bool operator>(const basic_iterator& a, const basic_iterator& b) { return a.m_index > b.m_index; }
+			friend bool operator<=(const basic_iterator& a, const basic_iterator& b) { return a.m_index <= b.m_index; }
+			friend bool operator>=(const basic_iterator& a, const basic_iterator& b) { return a.m_index >= b.m_index; }
+
+		private:
+			friend class basic_iterator<true>;
+
+			void seek(size_t i)
+			{
+				m_index = i;
+
+				// end() may sit past the allocated segments
+				const auto k = math::segment_of(i);
+				if (k < m_vec->m_allocated)
+				{
+					m_ptr = m_vec->m_segments[k] + (i - math::segment_begin(k));
+					m_segment_end = m_vec->m_segments[k] + math::segment_size(k);
+				}
+				else
+				{
+					m_ptr = nullptr;
+					m_segment_end = nullptr;
+				}
+			}
+
+			vector_type* m_vec = nullptr;
+			pointer m_ptr = nullptr;
+			pointer m_segment_end = nullptr;
+			size_t m_index = 0;
+		};
+
+		// the tail moves on to the next segment, allocating it when needed
+		ML_SPV_NOINLINE void next_segment()
+		{
+			const auto k = math::segment_of(m_size);
+			if (k == m_allocated)
+			{
+				allocate_segment(k);
+			}
+
+			m_end = m_segments[k];
+			m_segment_end = m_segments[k] + math::segment_size(k);
+		}
+
+		void allocate_segment(size_t k)
+		{
+			assert(k == m_allocated && k < math::max_segments);
+
+			auto result = impl::alloc_traits<Alloc>::allocate(get_alloc(), sizeof(T) * math::segment_size(k));
+			m_segments[k] = static_cast<T*>(result.ptr);
+			++m_allocated;
+		}
+
+		// frees the segments from first on
+		void free_segments(size_t first)
+		{
+			assert(first >= 1);
+
+			while (m_allocated > first)
+			{
+				--m_allocated;
+				impl::alloc_traits<Alloc>::deallocate(get_alloc(), m_segments[m_allocated], sizeof(T) * math::segment_size(m_allocated));
+				m_segments[m_allocated] = nullptr;
+			}
+		}
+
+		// the segments must be allocated. a size on a segment boundary ends the previous segment,
+		// the next one is only entered (and allocated) by the next append
+		void set_size(size_t n)
+		{
+			assert(n <= capacity());
+
+			m_size = n;
+
+			const auto k = n == 0 ? 0 : math::segment_of(n - 1);
+			m_end = m_segments[k] + (n - math::segment_begin(k));
+			m_segment_end = m_segments[k] + math::segment_size(k);
+		}
+
+		void take(segmented_pod_vector& v)
+		{
+			std::memcpy(m_static_data, v.m_static_data, std::min(v.m_size, StaticCapacity) * sizeof(T));
+
+			for (size_t k = 1; k < v.m_allocated; ++k)
+			{
+				m_segments[k] = v.m_segments[k];
+				v.m_segments[k] = nullptr;
+			}
+			m_allocated = v.m_allocated;
+			set_size(v.m_size);
+
+			v.m_allocated = 1;
+			v.set_size(0);
+		}
+
+		size_t m_size = 0;
+
+		// the end of the elements and of the segment they end in
+		T* m_end;
+		T* m_segment_end;
+
+		// segments [0, m_allocated) are allocated, [0] is m_static_data
+		size_t m_allocated = 1;
+		T* m_segments[math::max_segments] = {};
+
+		T m_static_data[StaticCapacity];
+	};
+
+}
@@ -0,0 +1,233 @@
+// ml-small_pod_vector serialize v1.00
+
+
+//                  VERSION HISTORY
+//
+//  1.00 blob format (write, append), blob_reader, small_pod_vector_view
+
+// a binary format for vectors of trivial types that is read in place. each vector is a blob:
+//
+//	uint64_t size				elements
+//	uint32_t element_size		sizeof(T)
+//	uint32_t magic				blob_magic
+//	T elements[size]			padded with zeros to a multiple of blob_alignment
+//
+// in the byte order of the writer. a buffer starting blob_alignment aligned (an mmap'ed file, a network
+// buffer from malloc) keeps every payload aligned, so blob_reader hands out views pointing into it and
+// loading costs nothing until materialize() makes an owning copy
+
+#pragma once
+
+#include "small_pod_vector.hpp"
+
+#include <cstdint>
+
+namespace ml
+{
+
+	// non-owning, read-only elements somewhere else: a vector, a file mapping, a network buffer
+	template<typename T>
+	class small_pod_vector_view
+	{
+		static_assert(std::is_trivial<T>::value, "ml::small_pod_vector_view with non-trivial type");
+
+	public:
+		using value_type = T;
+		using size_type = size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = const T&;
+		using const_reference = const T&;
+		using pointer = const T*;
+		using const_pointer = const T*;
+		using iterator = const T*;
+		using const_iterator = const T*;
+		using reverse_iterator = std::reverse_iterator<const_iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		small_pod_vector_view() = default;
+
+		small_pod_vector_view(const T* data, size_t size)
+			: m_data(data)
+			, m_size(size)
+		{}
+
+		// anything with data() and size(), a small_pod_vector or std::vector
+		template <typename Vec, typename = decltype(std::declval<const Vec&>().data() + std::declval<const Vec&>().size())>
+		small_pod_vector_view(const Vec& v)
+			: m_data(v.data())
+			, m_size(v.size())
+		{}
+
+		const_pointer data() const noexcept { return m_data; }
+		size_t size() const noexcept { return m_size; }
+		bool empty() const noexcept { return m_size == 0; }
+		size_t byte_size() const noexcept { return m_size * sizeof(T); }
+
+		const_iterator begin() const noexcept { return m_data; }
+		const_iterator end() const noexcept { return m_data + m_size; }
+		const_iterator cbegin() const noexcept { return begin(); }
+		const_iterator cend() const noexcept { return end(); }
+		const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+		const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+		const_reference operator[](size_t i) const
+		{
+			assert(i < m_size);
+			return m_data[i];
+		}
+
+		const_reference at(size_t i) const
+		{
+			assert(i < m_size);
+			return m_data[i];
+		}
+
+		const_reference front() const
+		{
+			assert(!empty());
+			return m_data[0];
+		}
+
+		const_reference back() const
+		{
+			assert(!empty());
+			return m_data[m_size - 1];
+		}
+
+		// an owning copy, one memcpy
+		template <typename Vec = small_pod_vector<T>>
+		Vec materialize() const
+		{
+			Vec vec;
+			if (m_size) std::memcpy(vec.append_uninitialized(m_size), m_data, byte_size());
+			return vec;
+		}
+
+	private:
+		const T* m_data = nullptr;
+		size_t m_size = 0;
+	};
+
+	template<typename T>
+	bool operator==(const small_pod_vector_view<T>& a, const small_pod_vector_view<T>& b)
+	{
+		return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.byte_size()) == 0);
+	}
+
+	template<typename T>
+	bool operator!=(const small_pod_vector_view<T>& a, const small_pod_vector_view<T>& b)
+	{
+		return !(a == b);
+	}
+
+	namespace serialize
+	{
+		static constexpr size_t blob_alignment = 16;
+		static constexpr uint32_t blob_magic = 0x31767073;	// "spv1"
+
+		struct blob_header
+		{
+			uint64_t size;
+			uint32_t element_size;
+			uint32_t magic;
+		};
+
+		static_assert(sizeof(blob_header) == blob_alignment, "ml::serialize: the header keeps the payload aligned");
+
+		inline size_t padded(size_t bytes)
+		{
+			return (bytes + blob_alignment - 1) & ~(blob_alignment - 1);
+		}
+
+		// the bytes the blob of n elements takes
+		template<typename T>
+		size_t blob_size(size_t n)
+		{
+			return sizeof(blob_header) + padded(n * sizeof(T));
+		}
+
+		// writes the blob of the n elements at p to out, which has room for blob_size<T>(n) bytes
+		// returns the bytes written
+		template<typename T>
+		size_t write(void* out, const T* p, size_t n)
+		{
+			static_assert(std::is_trivial<T>::value, "ml::serialize::write with non-trivial type");
+			static_assert(alignof(T) <= blob_alignment, "ml::serialize::write: the payload is only blob_alignment aligned");
+
+			const blob_header h = { uint64_t(n), uint32_t(sizeof(T)), blob_magic };
+			auto bytes = static_cast<unsigned char*>(out);
+			std::memcpy(bytes, &h, sizeof(h));
+
+			const auto payload = n * sizeof(T);
+			if (payload) std::memcpy(bytes + sizeof(h), p, payload);
+			std::memset(bytes + sizeof(h) + payload, 0, padded(payload) - payload);
+
+			return sizeof(h) + padded(payload);
+		}
+
+		// appends the blob of vec (anything with data() and size()) to a byte vector with append_uninitialized
+		template<typename Bytes, typename Vec>
+		void append(Bytes& out, const Vec& vec)
+		{
+			using T = typename std::remove_cv<typename std::remove_pointer<decltype(vec.data())>::type>::type;
+			static_assert(sizeof(*out.data()) == 1, "ml::serialize::append: the output must be a vector of bytes");
+
+			write(out.append_uninitialized(blob_size<T>(vec.size())), vec.data(), vec.size());
+		}
+
+		// walks the blobs of a buffer, handing out views into it. the buffer is checked, not trusted:
+		// a truncated blob, a wrong element size or magic, or a misaligned payload stops the reader
+		class blob_reader
+		{
+		public:
+			blob_reader(const void* data, size_t size)
+				: m_cur(static_cast<const unsigned char*>(data))
+				, m_end(m_cur + size)
+			{}
+
+			// the next blob as a view, false at the end or on a bad blob (see failed())
+			template<typename T>
+			bool next(small_pod_vector_view<T>& view)
+			{
+				if (m_failed || m_cur == m_end) return false;
+
+				blob_header h;
+				if (size_t(m_end - m_cur) < sizeof(h)) return fail();
+				std::memcpy(&h, m_cur, sizeof(h));
+
+				if (h.magic != blob_magic || h.element_size != sizeof(T)) return fail();
+
+				const auto available = size_t(m_end - m_cur) - sizeof(h);
+				if (h.size > available / sizeof(T)) return fail();
+
+				const auto payload = m_cur + sizeof(h);
+				if (reinterpret_cast<uintptr_t>(payload) % alignof(T) != 0) return fail();
+
+				const auto bytes = size_t(h.size) * sizeof(T);
+				if (padded(bytes) > available) return fail();
+
+				view = small_pod_vector_view<T>(reinterpret_cast<const T*>(payload), size_t(h.size));
+				m_cur = payload + padded(bytes);
+				return true;
+			}
+
+			bool at_end() const { return m_cur == m_end; }
+			bool failed() const { return m_failed; }
+
+			// bytes not read yet
+			size_t remaining() const { return size_t(m_end - m_cur); }
+
+		private:
+			bool fail()
+			{
+				m_failed = true;
+				return false;
+			}
+
+			const unsigned char* m_cur;
+			const unsigned char* m_end;
+			bool m_failed = false;
+		};
+	}
+
+}
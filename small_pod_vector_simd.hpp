@@ -0,0 +1,818 @@
+
+// ml-small_pod_vector simd v1.00
+
+
+//                  VERSION HISTORY
+//
+//  1.00 find, count, min_value, max_value, sum, equal, remove_if / erase_if
+
+// vectorized algorithms over the elements of a small_pod_vector (or any contiguous trivial array)
+// for int32_t, int64_t, uint8_t, float and double
+//
+// with gcc or clang on x86-64 every kernel is built for SSE2 (the baseline), AVX2 and AVX-512
+// from one generic implementation on gcc vector extensions, and the best the cpu supports is
+// picked at runtime. other compilers and targets get the scalar kernels
+//
+// float results follow the scalar code except for sum (the order of additions differs)
+// and min_value/max_value with NaNs (unspecified)
+
+#pragma once
+
+#include "small_pod_vector.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define ML_SPV_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define ML_SPV_SIMD_X86 0
+#endif
+
+namespace ml
+{
+
+	namespace simd
+	{
+		// instruction sets with kernels, in increasing order
+		enum class isa
+		{
+			scalar,
+			sse2,
+			avx2,	// and BMI2
+			avx512,	// F, BW and VL
+		};
+
+		// remove_if / erase_if take the condition as element <compare> value
+		enum class compare
+		{
+			equal,
+			not_equal,
+			less,
+			less_equal,
+			greater,
+			greater_equal,
+		};
+
+		template<typename T>
+		struct is_supported : std::integral_constant<bool,
+			std::is_same<T, int32_t>::value || std::is_same<T, int64_t>::value || std::is_same<T, uint8_t>::value ||
+			std::is_same<T, float>::value || std::is_same<T, double>::value>
+		{};
+
+		// what sum() returns: integers are summed in 64 bits, floating point in their own type
+		template<typename T>
+		using sum_type = typename std::conditional<std::is_floating_point<T>::value, T,
+			typename std::conditional<std::is_signed<T>::value, int64_t, uint64_t>::type>::type;
+
+		namespace impl
+		{
+			inline isa detect_isa()
+			{
+#if ML_SPV_SIMD_X86
+				__builtin_cpu_init();
+
+				if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl"))
+				{
+					return isa::avx512;
+				}
+				if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2"))
+				{
+					return isa::avx2;
+				}
+				return isa::sse2;
+#else
+				return isa::scalar;
+#endif
+			}
+
+			inline isa detected_isa()
+			{
+				static const isa level = detect_isa();
+				return level;
+			}
+
+			inline std::atomic<isa>& active_isa()
+			{
+				static std::atomic<isa> level{ detected_isa() };
+				return level;
+			}
+
+			// out = a <C> b, for scalars and vectors (out is a mask then)
+			// written through out, a vector return type would need the vector ABI
+			template<compare C, typename A, typename R>
+			void holds(const A& a, const A& b, R& out)
+			{
+				out = C == compare::equal ? R(a == b)
+					: C == compare::not_equal ? R(a != b)
+					: C == compare::less ? R(a < b)
+					: C == compare::less_equal ? R(a <= b)
+					: C == compare::greater ? R(a > b)
+					: R(a >= b);
+			}
+
+			template<compare C>
+			using compare_constant = std::integral_constant<compare, C>;
+
+			// calls f with the compare_constant of c
+			template<typename F>
+			auto with_compare(compare c, F f) -> decltype(f(compare_constant<compare::equal>()))
+			{
+				switch (c)
+				{
+				case compare::equal: return f(compare_constant<compare::equal>());
+				case compare::not_equal: return f(compare_constant<compare::not_equal>());
+				case compare::less: return f(compare_constant<compare::less>());
+				case compare::less_equal: return f(compare_constant<compare::less_equal>());
+				case compare::greater: return f(compare_constant<compare::greater>());
+				default: return f(compare_constant<compare::greater_equal>());
+				}
+			}
+
+			template<compare C, typename T>
+			bool holds(T a, T b)
+			{
+				bool r;
+				holds<C>(a, b, r);
+				return r;
+			}
+
+			namespace scalar
+			{
+				template<typename T>
+				size_t find(const T* p, size_t n, T value)
+				{
+					size_t i = 0;
+					while (i < n && !(p[i] == value))
+					{
+						++i;
+					}
+					return i;
+				}
+
+				template<typename T>
+				size_t count(const T* p, size_t n, T value)
+				{
+					size_t c = 0;
+					for (size_t i = 0; i < n; ++i)
+					{
+						c += p[i] == value;
+					}
+					return c;
+				}
+
+				// the element that holds C against all others, less gives the min
+				template<compare C, typename T>
+				T reduce(const T* p, size_t n, T r)
+				{
+					for (size_t i = 0; i < n; ++i)
+					{
+						r = holds<C>(p[i], r) ? p[i] : r;
+					}
+					return r;
+				}
+
+				template<typename T>
+				T min_value(const T* p, size_t n)
+				{
+					return reduce<compare::less>(p + 1, n - 1, p[0]);
+				}
+
+				template<typename T>
+				T max_value(const T* p, size_t n)
+				{
+					return reduce<compare::greater>(p + 1, n - 1, p[0]);
+				}
+
+				template<typename T>
+				sum_type<T> sum(const T* p, size_t n)
+				{
+					sum_type<T> s = 0;
+					for (size_t i = 0; i < n; ++i)
+					{
+						s += p[i];
+					}
+					return s;
+				}
+
+				template<typename T>
+				bool equal(const T* a, const T* b, size_t n)
+				{
+					for (size_t i = 0; i < n; ++i)
+					{
+						if (!(a[i] == b[i])) return false;
+					}
+					return true;
+				}
+
+				// branch free, the element is always written and the output only advances when it's kept
+				// from in to out (which may be the same or before it), returns the number kept
+				template<compare C, typename T>
+				size_t remove_if(T* out, const T* in, size_t n, T value)
+				{
+					size_t k = 0;
+					for (size_t i = 0; i < n; ++i)
+					{
+						const auto v = in[i];
+						out[k] = v;
+						k += !holds<C>(v, value);
+					}
+					return k;
+				}
+
+				template<compare C, typename T>
+				size_t remove_if(T* p, size_t n, T value)
+				{
+					return remove_if<C>(p, p, n, value);
+				}
+			}
+
+#if ML_SPV_SIMD_X86
+			// generic kernels on Bytes wide vectors (gcc vector extensions). they are built for an
+			// instruction set by being inlined (flatten) into the target specific entry points further down,
+			// Ops adds what the vector extensions can't express well: the any-lane test, the byte sum and
+			// the compress store
+			namespace vector
+			{
+				template<typename T, size_t Bytes>
+				struct vector_of
+				{
+					typedef T type __attribute__((vector_size(Bytes)));
+				};
+
+				template<typename T, size_t Bytes>
+				struct types
+				{
+					static constexpr size_t lanes = Bytes / sizeof(T);
+
+					typedef typename vector_of<T, Bytes>::type vec;
+					typedef decltype(vec() == vec()) mask;
+					typedef typename vector_of<typename std::conditional<sizeof(T) == 1, uint8_t, typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type>::type, Bytes>::type counters;
+
+					// the vectors are passed by reference or written through out, see holds()
+
+					static void load(vec& out, const T* p)
+					{
+						std::memcpy(&out, p, sizeof(out));
+					}
+
+					static void splat(vec& out, T value)
+					{
+						for (size_t l = 0; l < lanes; ++l)
+						{
+							out[l] = value;
+						}
+					}
+
+					// lanes of a where m is set
+					static void select(const mask& m, const vec& a, vec& out)
+					{
+						out = vec((mask(a) & m) | (mask(out) & ~m));
+					}
+				};
+
+				template<typename T, size_t Bytes, typename Ops>
+				size_t find(const T* p, size_t n, T value)
+				{
+					using t = types<T, Bytes>;
+					typename t::vec v, x;
+					typename t::mask m;
+					t::splat(v, value);
+
+					size_t i = 0;
+					for (; i + t::lanes <= n; i += t::lanes)
+					{
+						t::load(x, p + i);
+						holds<compare::equal>(x, v, m);
+						if (Ops::any(m))
+						{
+							return i + scalar::find(p + i, t::lanes, value);
+						}
+					}
+					return i + scalar::find(p + i, n - i, value);
+				}
+
+				template<typename T, size_t Bytes>
+				size_t count(const T* p, size_t n, T value)
+				{
+					using t = types<T, Bytes>;
+					typename t::vec v, x;
+					typename t::mask m;
+					t::splat(v, value);
+
+					size_t c = 0;
+					size_t i = 0;
+					while (i + t::lanes <= n)
+					{
+						// a match is all ones (-1) in the mask, so it's subtracted. flush before a byte lane can overflow
+						const size_t block = sizeof(T) == 1 ? 255 : 1 << 20;
+						auto end = i + block * t::lanes < n ? i + block * t::lanes : n;
+
+						typename t::counters acc = {};
+						for (; i + t::lanes <= end; i += t::lanes)
+						{
+							t::load(x, p + i);
+							holds<compare::equal>(x, v, m);
+							acc -= typename t::counters(m);
+						}
+
+						for (size_t l = 0; l < t::lanes; ++l)
+						{
+							c += size_t(acc[l]);
+						}
+					}
+					return c + scalar::count(p + i, n - i, value);
+				}
+
+				// the element that holds C against all others, less gives the min
+				template<typename T, size_t Bytes, compare C>
+				T reduce(const T* p, size_t n)
+				{
+					using t = types<T, Bytes>;
+
+					// four accumulators, a compare and select is a long dependency chain
+					const size_t ways = 4;
+
+					if (n < ways * t::lanes) return scalar::reduce<C>(p + 1, n - 1, p[0]);
+
+					typename t::vec acc[ways], x;
+					typename t::mask m;
+					for (size_t w = 0; w < ways; ++w)
+					{
+						t::load(acc[w], p + w * t::lanes);
+					}
+
+					size_t i = ways * t::lanes;
+					for (; i + ways * t::lanes <= n; i += ways * t::lanes)
+					{
+						for (size_t w = 0; w < ways; ++w)
+						{
+							t::load(x, p + i + w * t::lanes);
+							holds<C>(x, acc[w], m);
+							t::select(m, x, acc[w]);
+						}
+					}
+
+					T lanes[ways * t::lanes];
+					std::memcpy(lanes, acc, sizeof(acc));
+					const auto r = scalar::reduce<C>(lanes + 1, ways * t::lanes - 1, lanes[0]);
+					return scalar::reduce<C>(p + i, n - i, r);
+				}
+
+				template<typename T, size_t Bytes, typename Ops>
+				sum_type<T> sum(const T* p, size_t n, std::false_type)
+				{
+					using t = types<T, Bytes>;
+					// a vector of T is widened in parts that each fill an accumulator of sum_type lanes
+					const size_t parts = sizeof(sum_type<T>) / sizeof(T);
+					typedef typename vector_of<T, Bytes / parts>::type part;
+					typedef typename vector_of<sum_type<T>, Bytes>::type acc_vec;
+
+					part x;
+					acc_vec acc = {};
+
+					size_t i = 0;
+					for (; i + t::lanes <= n; i += t::lanes)
+					{
+						for (size_t k = 0; k < parts; ++k)
+						{
+							std::memcpy(&x, p + i + k * t::lanes / parts, sizeof(x));
+							acc += __builtin_convertvector(x, acc_vec);
+						}
+					}
+
+					sum_type<T> s = 0;
+					for (size_t l = 0; l < Bytes / sizeof(sum_type<T>); ++l)
+					{
+						s += acc[l];
+					}
+					return s + scalar::sum(p + i, n - i);
+				}
+
+				// bytes are summed in groups of 8 into 64-bit lanes by Ops::add_bytes
+				template<typename T, size_t Bytes, typename Ops>
+				sum_type<T> sum(const T* p, size_t n, std::true_type)
+				{
+					using t = types<T, Bytes>;
+					typename t::vec x;
+					typename vector_of<uint64_t, Bytes>::type acc = {};
+
+					size_t i = 0;
+					for (; i + t::lanes <= n; i += t::lanes)
+					{
+						t::load(x, p + i);
+						Ops::add_bytes(x, acc);
+					}
+
+					sum_type<T> s = 0;
+					for (size_t l = 0; l < Bytes / 8; ++l)
+					{
+						s += acc[l];
+					}
+					return s + scalar::sum(p + i, n - i);
+				}
+
+				template<typename T, size_t Bytes, typename Ops>
+				sum_type<T> sum(const T* p, size_t n)
+				{
+					return sum<T, Bytes, Ops>(p, n, std::integral_constant<bool, sizeof(T) == 1>());
+				}
+
+				template<typename T, size_t Bytes, typename Ops>
+				bool equal(const T* a, const T* b, size_t n)
+				{
+					using t = types<T, Bytes>;
+					typename t::vec x, y;
+					typename t::mask m;
+
+					size_t i = 0;
+					for (; i + t::lanes <= n; i += t::lanes)
+					{
+						t::load(x, a + i);
+						t::load(y, b + i);
+						holds<compare::not_equal>(x, y, m);
+						if (Ops::any(m)) return false;
+					}
+					return scalar::equal(a + i, b + i, n - i);
+				}
+
+				// without a compress store the branch free scalar loop is as good as it gets
+				template<typename T, size_t Bytes, compare C, typename Ops>
+				size_t remove_if(T* p, size_t n, T value, std::false_type)
+				{
+					return scalar::remove_if<C>(p, n, value);
+				}
+
+				template<typename T, size_t Bytes, compare C, typename Ops>
+				size_t remove_if(T* p, size_t n, T value, std::true_type)
+				{
+					using t = types<T, Bytes>;
+					typename t::vec v, x;
+					typename t::mask m;
+					t::splat(v, value);
+
+					// the output never gets ahead of the loaded vector, so working in place is safe
+					size_t out = 0;
+					size_t i = 0;
+					for (; i + t::lanes <= n; i += t::lanes)
+					{
+						t::load(x, p + i);
+						holds<C>(x, v, m);
+						out += Ops::compress(p + out, x, m);
+					}
+
+					return out + scalar::remove_if<C>(p + out, p + i, n - i, value);
+				}
+
+				template<typename T, size_t Bytes, compare C, typename Ops>
+				size_t remove_if(T* p, size_t n, T value)
+				{
+					return remove_if<T, Bytes, C, Ops>(p, n, value, std::integral_constant<bool, Ops::template compresses<T>()>());
+				}
+			}
+
+			// the Ops of the generic kernels per instruction set
+
+			struct sse2_ops
+			{
+				template<typename M>
+				static bool any(const M& m)
+				{
+					__m128i mi;
+					std::memcpy(&mi, &m, sizeof(mi));
+					return _mm_movemask_epi8(mi) != 0;
+				}
+
+				template<typename V, typename A>
+				static void add_bytes(const V& x, A& acc)
+				{
+					__m128i xi, ai;
+					std::memcpy(&xi, &x, sizeof(xi));
+					std::memcpy(&ai, &acc, sizeof(ai));
+					ai = _mm_add_epi64(ai, _mm_sad_epu8(xi, _mm_setzero_si128()));
+					std::memcpy(&acc, &ai, sizeof(ai));
+				}
+
+				template<typename T>
+				static constexpr bool compresses() { return false; }
+
+				template<typename T, typename V, typename M>
+				static size_t compress(T*, const V&, const M&) { return 0; }
+			};
+
+			// compress stores through a permutation whose indices are gathered with pext
+			struct avx2_ops
+			{
+				template<typename M>
+				__attribute__((target("avx2,bmi2")))
+				static bool any(const M& m)
+				{
+					__m256i mi;
+					std::memcpy(&mi, &m, sizeof(mi));
+					return !_mm256_testz_si256(mi, mi);
+				}
+
+				template<typename V, typename A>
+				__attribute__((target("avx2,bmi2")))
+				static void add_bytes(const V& x, A& acc)
+				{
+					__m256i xi, ai;
+					std::memcpy(&xi, &x, sizeof(xi));
+					std::memcpy(&ai, &acc, sizeof(ai));
+					ai = _mm256_add_epi64(ai, _mm256_sad_epu8(xi, _mm256_setzero_si256()));
+					std::memcpy(&acc, &ai, sizeof(ai));
+				}
+
+				// bytes would need a 32 entry byte shuffle
+				template<typename T>
+				static constexpr bool compresses() { return sizeof(T) != 1; }
+
+				template<typename T, typename V, typename M>
+				__attribute__((target("avx2,bmi2")))
+				static size_t compress(T* out, const V& x, const M& remove)
+				{
+					return compress(out, x, remove, std::integral_constant<size_t, sizeof(T)>());
+				}
+
+			private:
+
+				// keep has a bit per 32-bit lane
+				__attribute__((target("avx2,bmi2")))
+				static void permute_store(void* out, __m256i x, uint32_t keep)
+				{
+					// a byte of 0xff per kept lane, then the kept lane numbers packed to the low bytes
+					const uint64_t bytes = _pdep_u64(keep, 0x0101010101010101) * 0xff;
+					const uint64_t indices = _pext_u64(0x0706050403020100, bytes);
+
+					const __m256i permutation = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(int64_t(indices)));
+					_mm256_storeu_si256(static_cast<__m256i*>(out), _mm256_permutevar8x32_epi32(x, permutation));
+				}
+
+				template<typename T, typename V, typename M>
+				__attribute__((target("avx2,bmi2")))
+				static size_t compress(T* out, const V& x, const M& remove, std::integral_constant<size_t, 4>)
+				{
+					__m256i xi, mi;
+					std::memcpy(&xi, &x, sizeof(xi));
+					std::memcpy(&mi, &remove, sizeof(mi));
+
+					const auto keep = uint32_t(~_mm256_movemask_ps(_mm256_castsi256_ps(mi)) & 0xff);
+					permute_store(out, xi, keep);
+					return size_t(__builtin_popcount(keep));
+				}
+
+				template<typename T, typename V, typename M>
+				__attribute__((target("avx2,bmi2")))
+				static size_t compress(T* out, const V& x, const M& remove, std::integral_constant<size_t, 8>)
+				{
+					__m256i xi, mi;
+					std::memcpy(&xi, &x, sizeof(xi));
+					std::memcpy(&mi, &remove, sizeof(mi));
+
+					// a 64-bit lane moves as two 32-bit ones
+					const auto keep = uint32_t(~_mm256_movemask_ps(_mm256_castsi256_ps(mi)) & 0xff);
+					permute_store(out, xi, keep);
+					return size_t(__builtin_popcount(keep)) / 2;
+				}
+			};
+
+			struct avx512_ops
+			{
+				template<typename M>
+				__attribute__((target("avx512f,avx512bw,avx512vl")))
+				static bool any(const M& m)
+				{
+					__m512i mi;
+					std::memcpy(&mi, &m, sizeof(mi));
+					return _mm512_test_epi64_mask(mi, mi) != 0;
+				}
+
+				template<typename V, typename A>
+				__attribute__((target("avx512f,avx512bw,avx512vl")))
+				static void add_bytes(const V& x, A& acc)
+				{
+					__m512i xi, ai;
+					std::memcpy(&xi, &x, sizeof(xi));
+					std::memcpy(&ai, &acc, sizeof(ai));
+					ai = _mm512_add_epi64(ai, _mm512_sad_epu8(xi, _mm512_setzero_si512()));
+					std::memcpy(&acc, &ai, sizeof(ai));
+				}
+
+				// byte compress stores are VBMI2
+				template<typename T>
+				static constexpr bool compresses() { return sizeof(T) != 1; }
+
+				template<typename T, typename V, typename M>
+				__attribute__((target("avx512f,avx512bw,avx512vl")))
+				static size_t compress(T* out, const V& x, const M& remove)
+				{
+					return compress(out, x, remove, std::integral_constant<size_t, sizeof(T)>());
+				}
+
+			private:
+
+				template<typename T, typename V, typename M>
+				__attribute__((target("avx512f,avx512bw,avx512vl")))
+				static size_t compress(T* out, const V& x, const M& remove, std::integral_constant<size_t, 4>)
+				{
+					__m512i xi, mi;
+					std::memcpy(&xi, &x, sizeof(xi));
+					std::memcpy(&mi, &remove, sizeof(mi));
+
+					const __mmask16 keep = _mm512_testn_epi32_mask(mi, mi);
+					_mm512_mask_compressstoreu_epi32(out, keep, xi);
+					return size_t(__builtin_popcount(keep));
+				}
+
+				template<typename T, typename V, typename M>
+				__attribute__((target("avx512f,avx512bw,avx512vl")))
+				static size_t compress(T* out, const V& x, const M& remove, std::integral_constant<size_t, 8>)
+				{
+					__m512i xi, mi;
+					std::memcpy(&xi, &x, sizeof(xi));
+					std::memcpy(&mi, &remove, sizeof(mi));
+
+					const __mmask8 keep = _mm512_testn_epi64_mask(mi, mi);
+					_mm512_mask_compressstoreu_epi64(out, keep, xi);
+					return size_t(__builtin_popcount(keep));
+				}
+			};
+
+			// entry points per instruction set, the generic kernels are built for it by flatten
+#define ML_SPV_SIMD_KERNELS(TARGET, BYTES, OPS) \
+			template<typename T> TARGET size_t find(const T* p, size_t n, T value) { return vector::find<T, BYTES, OPS>(p, n, value); } \
+			template<typename T> TARGET size_t count(const T* p, size_t n, T value) { return vector::count<T, BYTES>(p, n, value); } \
+			template<typename T> TARGET T min_value(const T* p, size_t n) { return vector::reduce<T, BYTES, compare::less>(p, n); } \
+			template<typename T> TARGET T max_value(const T* p, size_t n) { return vector::reduce<T, BYTES, compare::greater>(p, n); } \
+			template<typename T> TARGET sum_type<T> sum(const T* p, size_t n) { return vector::sum<T, BYTES, OPS>(p, n); } \
+			template<typename T> TARGET bool equal(const T* a, const T* b, size_t n) { return vector::equal<T, BYTES, OPS>(a, b, n); } \
+			template<compare C, typename T> TARGET size_t remove_if(T* p, size_t n, T value) { return vector::remove_if<T, BYTES, C, OPS>(p, n, value); }
+
+			namespace sse2
+			{
+				ML_SPV_SIMD_KERNELS(__attribute__((flatten)), 16, sse2_ops)
+			}
+
+			namespace avx2
+			{
+				ML_SPV_SIMD_KERNELS(__attribute__((target("avx2,bmi2"), flatten)), 32, avx2_ops)
+			}
+
+			namespace avx512
+			{
+				ML_SPV_SIMD_KERNELS(__attribute__((target("avx512f,avx512bw,avx512vl"), flatten)), 64, avx512_ops)
+			}
+
+#undef ML_SPV_SIMD_KERNELS
+#endif
+		}
+
+		// the instruction set the kernels run with, the best one the cpu supports unless set_isa() said otherwise
+		inline isa get_isa()
+		{
+			return impl::active_isa().load(std::memory_order_relaxed);
+		}
+
+		// for tests and benchmarks, a level the cpu doesn't support is lowered to the detected one
+		// returns the level now in use
+		inline isa set_isa(isa level)
+		{
+			if (level > impl::detected_isa())
+			{
+				level = impl::detected_isa();
+			}
+			impl::active_isa().store(level, std::memory_order_relaxed);
+			return level;
+		}
+
+#if ML_SPV_SIMD_X86
+#define ML_SPV_SIMD_DISPATCH(CALL) \
+		switch (get_isa()) \
+		{ \
+		case isa::avx512: return impl::avx512::CALL; \
+		case isa::avx2: return impl::avx2::CALL; \
+		case isa::sse2: return impl::sse2::CALL; \
+		default: return impl::scalar::CALL; \
+		}
+#else
+#define ML_SPV_SIMD_DISPATCH(CALL) return impl::scalar::CALL;
+#endif
+
+		// index of the first element equal to value, n if there's none
+		template<typename T>
+		size_t find(const T* p, size_t n, T value)
+		{
+			static_assert(is_supported<T>::value, "ml::simd: unsupported element type");
+			ML_SPV_SIMD_DISPATCH(find(p, n, value))
+		}
+
+		template<typename T>
+		size_t count(const T* p, size_t n, T value)
+		{
+			static_assert(is_supported<T>::value, "ml::simd: unsupported element type");
+			ML_SPV_SIMD_DISPATCH(count(p, n, value))
+		}
+
+		// n must not be 0
+		template<typename T>
+		T min_value(const T* p, size_t n)
+		{
+			static_assert(is_supported<T>::value, "ml::simd: unsupported element type");
+			assert(n > 0);
+			ML_SPV_SIMD_DISPATCH(min_value(p, n))
+		}
+
+		// n must not be 0
+		template<typename T>
+		T max_value(const T* p, size_t n)
+		{
+			static_assert(is_supported<T>::value, "ml::simd: unsupported element type");
+			assert(n > 0);
+			ML_SPV_SIMD_DISPATCH(max_value(p, n))
+		}
+
+		template<typename T>
+		sum_type<T> sum(const T* p, size_t n)
+		{
+			static_assert(is_supported<T>::value, "ml::simd: unsupported element type");
+			ML_SPV_SIMD_DISPATCH(sum(p, n))
+		}
+
+		// element wise ==, so NaNs differ and -0.0 equals 0.0
+		// integers compare bitwise, which std::memcmp does best
+		template<typename T>
+		bool equal(const T* a, const T* b, size_t n)
+		{
+			static_assert(is_supported<T>::value, "ml::simd: unsupported element type");
+			if (std::is_integral<T>::value)
+			{
+				return n == 0 || std::memcmp(a, b, n * sizeof(T)) == 0;
+			}
+			ML_SPV_SIMD_DISPATCH(equal(a, b, n))
+		}
+
+		// removes the elements for which element <c> value holds, keeping the order of the rest
+		// returns the new size
+		template<typename T>
+		size_t remove_if(T* p, size_t n, compare c, T value)
+		{
+			static_assert(is_supported<T>::value, "ml::simd: unsupported element type");
+			return impl::with_compare(c, [&](auto op)
+			{
+				ML_SPV_SIMD_DISPATCH(template remove_if<decltype(op)::value>(p, n, value))
+			});
+		}
+
+#undef ML_SPV_SIMD_DISPATCH
+
+		// the same on a vector (anything with data() and size())
+
+		template<typename Vec>
+		auto find(Vec& vec, typename Vec::value_type value) -> decltype(vec.begin())
+		{
+			return vec.begin() + find(vec.data(), vec.size(), value);
+		}
+
+		template<typename Vec>
+		size_t count(const Vec& vec, typename Vec::value_type value)
+		{
+			return count(vec.data(), vec.size(), value);
+		}
+
+		template<typename Vec>
+		typename Vec::value_type min_value(const Vec& vec)
+		{
+			return min_value(vec.data(), vec.size());
+		}
+
+		template<typename Vec>
+		typename Vec::value_type max_value(const Vec& vec)
+		{
+			return max_value(vec.data(), vec.size());
+		}
+
+		template<typename Vec>
+		sum_type<typename Vec::value_type> sum(const Vec& vec)
+		{
+			return sum(vec.data(), vec.size());
+		}
+
+		template<typename Vec1, typename Vec2>
+		bool equal(const Vec1& a, const Vec2& b)
+		{
+			return a.size() == b.size() && equal(a.data(), b.data(), a.size());
+		}
+
+		// like std::erase_if, returns the number of elements removed
+		template<typename Vec>
+		size_t erase_if(Vec& vec, compare c, typename Vec::value_type value)
+		{
+			const auto s = vec.size();
+			vec.resize(remove_if(vec.data(), s, c, value));
+			return s - vec.size();
+		}
+	}
+
+}
@@ -0,0 +1,296 @@
+// ml-small_pod_vector stats v1.01
+
+
+//                  VERSION HISTORY
+//
+//  1.00 counting stats policy, dump()
+//  1.01 peak() for derived policies (see small_pod_vector_profiler.hpp)
+
+// a StatsPolicy for ml::small_pod_vector (see small_pod_vector.hpp) recording spills, reverts,
+// allocations, bytes copied and peak sizes, to tune StaticCapacity per call site
+
+#pragma once
+
+#include "small_pod_vector.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+
+namespace ml
+{
+
+	namespace stats
+	{
+		// peak sizes are counted in power of two buckets
+		static constexpr size_t peak_buckets = 32;
+
+		struct statistics
+		{
+			uint64_t allocations = 0;		// dynamic buffers allocated
+			uint64_t frees = 0;				// and freed
+			uint64_t reallocations = 0;		// dynamic buffers resized (in place or moved)
+			uint64_t bytes_allocated = 0;	// by allocations and reallocations
+			uint64_t spills = 0;			// moves from the static buffer to a dynamic one
+			uint64_t reverts = 0;			// moves from a dynamic buffer back to the static one
+			uint64_t bytes_copied = 0;		// by spills, reverts and reallocations that moved the buffer
+			uint64_t vectors = 0;			// destroyed vectors that held elements
+
+			// those vectors by peak size: [0] 1 element, [i] (2^(i-1), 2^i] elements, the last one everything above
+			uint64_t peak_sizes[peak_buckets] = {};
+		};
+
+		inline size_t peak_bucket(size_t peak)
+		{
+			size_t b = 0;
+			while (b + 1 < peak_buckets && (size_t(1) << b) < peak)
+			{
+				++b;
+			}
+			return b;
+		}
+
+		// per thread counters summed by snapshot(), updated with relaxed atomics and no read-modify-write
+		// vectors with a different Tag are counted separately
+		template<typename Tag = void>
+		class counting
+		{
+		public:
+			counting() = default;
+
+			// a copy starts out on its own
+			counting(const counting&) {}
+			counting& operator=(const counting&) { return *this; }
+
+			~counting()
+			{
+				auto c = current();
+				if (m_peak && c)
+				{
+					count(c->vectors);
+					count(c->peak_sizes[peak_bucket(m_peak)]);
+				}
+			}
+
+			void on_allocate(size_t bytes)
+			{
+				auto c = current();
+				if (!c) return;
+				count(c->allocations);
+				count(c->bytes_allocated, bytes);
+			}
+
+			void on_free(size_t)
+			{
+				auto c = current();
+				if (!c) return;
+				count(c->frees);
+			}
+
+			void on_reallocate(size_t, size_t new_bytes, size_t copied)
+			{
+				auto c = current();
+				if (!c) return;
+				count(c->reallocations);
+				count(c->bytes_allocated, new_bytes);
+				count(c->bytes_copied, copied);
+			}
+
+			void on_spill(size_t copied)
+			{
+				auto c = current();
+				if (!c) return;
+				count(c->spills);
+				count(c->bytes_copied, copied);
+			}
+
+			void on_revert(size_t copied)
+			{
+				auto c = current();
+				if (!c) return;
+				count(c->reverts);
+				count(c->bytes_copied, copied);
+			}
+
+			void on_size(size_t size)
+			{
+				if (size > m_peak)
+				{
+					m_peak = size;
+				}
+			}
+
+			// the peak goes along with the elements, so a moved-from vector isn't counted
+			void on_move_from(counting& other)
+			{
+				on_size(other.m_peak);
+				other.m_peak = 0;
+			}
+
+			// summed over all threads that ever recorded anything
+			static statistics snapshot()
+			{
+				statistics s;
+
+				auto& r = get_registry();
+				std::lock_guard<std::mutex> lock(r.mutex);
+
+				for (auto c = r.all; c; c = c->next_registered)
+				{
+					s.allocations += c->allocations.load(std::memory_order_relaxed);
+					s.frees += c->frees.load(std::memory_order_relaxed);
+					s.reallocations += c->reallocations.load(std::memory_order_relaxed);
+					s.bytes_allocated += c->bytes_allocated.load(std::memory_order_relaxed);
+					s.spills += c->spills.load(std::memory_order_relaxed);
+					s.reverts += c->reverts.load(std::memory_order_relaxed);
+					s.bytes_copied += c->bytes_copied.load(std::memory_order_relaxed);
+					s.vectors += c->vectors.load(std::memory_order_relaxed);
+
+					for (size_t b = 0; b < peak_buckets; ++b)
+					{
+						s.peak_sizes[b] += c->peak_sizes[b].load(std::memory_order_relaxed);
+					}
+				}
+
+				return s;
+			}
+
+		protected:
+			// the largest size this vector had, 0 once moved from
+			size_t peak() const
+			{
+				return m_peak;
+			}
+
+		private:
+			struct counters
+			{
+				std::atomic<uint64_t> allocations;
+				std::atomic<uint64_t> frees;
+				std::atomic<uint64_t> reallocations;
+				std::atomic<uint64_t> bytes_allocated;
+				std::atomic<uint64_t> spills;
+				std::atomic<uint64_t> reverts;
+				std::atomic<uint64_t> bytes_copied;
+				std::atomic<uint64_t> vectors;
+				std::atomic<uint64_t> peak_sizes[peak_buckets];
+
+				counters* next_registered;
+				counters* next_parked;
+			};
+
+			// single writer
+			static void count(std::atomic<uint64_t>& counter, uint64_t n = 1)
+			{
+				counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+			}
+
+			struct registry
+			{
+				std::mutex mutex;
+				counters* all = nullptr;
+				counters* parked = nullptr;
+			};
+
+			static registry& get_registry()
+			{
+				// never destroyed, vectors may die during static destruction
+				static registry* r = new registry;
+				return *r;
+			}
+
+			// adopts the counters of an exited thread or creates them, parks them again on thread exit
+			struct counters_owner
+			{
+				counters* c;
+
+				counters_owner()
+				{
+					auto& r = get_registry();
+					std::lock_guard<std::mutex> lock(r.mutex);
+
+					if (r.parked)
+					{
+						c = r.parked;
+						r.parked = c->next_parked;
+					}
+					else
+					{
+						// value initialized, so the counters start at zero
+						c = new counters();
+						c->next_registered = r.all;
+						r.all = c;
+					}
+				}
+
+				~counters_owner()
+				{
+					thread_counters() = exited();
+
+					auto& r = get_registry();
+					std::lock_guard<std::mutex> lock(r.mutex);
+
+					c->next_parked = r.parked;
+					r.parked = c;
+				}
+			};
+
+			static counters*& thread_counters()
+			{
+				// trivially destructible, so it can still be read after counters_owner is gone
+				static thread_local counters* c = nullptr;
+				return c;
+			}
+
+			static counters* exited()
+			{
+				return reinterpret_cast<counters*>(uintptr_t(1));
+			}
+
+			// nullptr once the thread's counters have been parked, what vectors do after that isn't counted
+			static counters* current()
+			{
+				auto& c = thread_counters();
+				if (!c)
+				{
+					static thread_local counters_owner owner;
+					c = owner.c;
+				}
+				return c == exited() ? nullptr : c;
+			}
+
+			size_t m_peak = 0;
+		};
+
+		// a readable summary, one line per counter and one per non-empty peak size bucket
+		inline void dump(const statistics& s, const char* name = "small_pod_vector", std::FILE* out = stderr)
+		{
+			std::fprintf(out, "%s stats\n", name);
+			std::fprintf(out, "  allocations      %llu\n", (unsigned long long)s.allocations);
+			std::fprintf(out, "  frees            %llu\n", (unsigned long long)s.frees);
+			std::fprintf(out, "  reallocations    %llu\n", (unsigned long long)s.reallocations);
+			std::fprintf(out, "  bytes allocated  %llu\n", (unsigned long long)s.bytes_allocated);
+			std::fprintf(out, "  spills           %llu\n", (unsigned long long)s.spills);
+			std::fprintf(out, "  reverts          %llu\n", (unsigned long long)s.reverts);
+			std::fprintf(out, "  bytes copied     %llu\n", (unsigned long long)s.bytes_copied);
+			std::fprintf(out, "  vectors          %llu\n", (unsigned long long)s.vectors);
+
+			for (size_t b = 0; b < peak_buckets; ++b)
+			{
+				if (!s.peak_sizes[b]) continue;
+
+				const auto low = b == 0 ? 1ull : (1ull << (b - 1)) + 1;
+				if (b + 1 == peak_buckets)
+				{
+					std::fprintf(out, "  peak >= %llu: %llu\n", low, (unsigned long long)s.peak_sizes[b]);
+				}
+				else
+				{
+					std::fprintf(out, "  peak %llu..%llu: %llu\n", low, 1ull << b, (unsigned long long)s.peak_sizes[b]);
+				}
+			}
+		}
+	}
+
+}
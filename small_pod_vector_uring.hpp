@@ -0,0 +1,453 @@
+// ml-small_pod_vector uring v1.01
+
+
+//                  VERSION HISTORY
+//
+//  1.00 uring::ring, asynchronous read into the tail / write from data(), callbacks and coroutines
+//  1.01 transfers clamped to max_transfer bytes, reads into vectors below RevertToStaticSize,
+//       a full submission queue is submitted until it has room, or the operation fails
+
+// asynchronous file I/O on vectors with io_uring (linux 5.6 and later). a read fills the reserved tail
+// of a vector and grows it by what arrived (like io::pread_append), a write sends data(). completions run
+// a callback, or resume a coroutine in C++20
+//
+// the kernel holds on to the buffer until the completion, so it must not move: while an operation is in
+// flight its vector isn't resized, moved or destroyed. debug builds pin the buffer (see ML_SPV_CHECK_PINS)
+// and assert on a reallocation. one read per vector at a time, a read owns the tail
+//
+// an sqe holds a 32 bit length, so one operation moves at most max_transfer bytes. longer reads and
+// writes are short, like the system calls, and the completion tells how much went through
+//
+// the ring talks to the kernel through the system calls and the shared rings of <linux/io_uring.h>,
+// there's no liburing dependency
+
+#pragma once
+
+#include "small_pod_vector_io.hpp"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define ML_SPV_HAS_URING 1
+#endif
+#endif
+
+#ifdef ML_SPV_HAS_URING
+
+#include <cerrno>
+#include <cstdint>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define ML_SPV_URING_COROUTINES 1
+#endif
+
+namespace ml
+{
+
+	namespace uring
+	{
+		class ring
+		{
+		public:
+			// the most bytes one operation moves
+			static constexpr size_t max_transfer = UINT32_MAX;
+
+			// entries is the submission queue size, the completion queue is twice that
+			explicit ring(unsigned entries = 256)
+			{
+				io_uring_params p;
+				std::memset(&p, 0, sizeof(p));
+
+				m_fd = int(::syscall(__NR_io_uring_setup, entries, &p));
+				if (m_fd < 0)
+				{
+					m_error = errno;
+					return;
+				}
+
+				m_sq_size = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+				m_cq_size = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+
+				// one mapping holds both rings on kernels with IORING_FEAT_SINGLE_MMAP
+				m_single_mmap = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+				if (m_single_mmap)
+				{
+					m_sq_size = m_cq_size = m_sq_size > m_cq_size ? m_sq_size : m_cq_size;
+				}
+
+				m_sq_ring = map(m_sq_size, IORING_OFF_SQ_RING);
+				m_cq_ring = m_single_mmap ? m_sq_ring : map(m_cq_size, IORING_OFF_CQ_RING);
+				m_sqes = static_cast<io_uring_sqe*>(map(p.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES));
+				m_sqes_size = p.sq_entries * sizeof(io_uring_sqe);
+
+				if (!m_sq_ring || !m_cq_ring || !m_sqes)
+				{
+					m_error = errno;
+					release();
+					return;
+				}
+
+				auto sq = static_cast<char*>(m_sq_ring);
+				m_sq_tail = reinterpret_cast<uint32_t*>(sq + p.sq_off.tail);
+				m_sq_mask = *reinterpret_cast<uint32_t*>(sq + p.sq_off.ring_mask);
+				m_sq_array = reinterpret_cast<uint32_t*>(sq + p.sq_off.array);
+				m_sq_entries = p.sq_entries;
+
+				auto cq = static_cast<char*>(m_cq_ring);
+				m_cq_head = reinterpret_cast<uint32_t*>(cq + p.cq_off.head);
+				m_cq_tail = reinterpret_cast<uint32_t*>(cq + p.cq_off.tail);
+				m_cq_mask = *reinterpret_cast<uint32_t*>(cq + p.cq_off.ring_mask);
+				m_cqes = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+				m_cq_entries = p.cq_entries;
+			}
+
+			ring(const ring&) = delete;
+			ring& operator=(const ring&) = delete;
+
+			// the operations still in flight are waited for, so their buffers are released
+			~ring()
+			{
+				if (valid())
+				{
+					while (m_in_flight && wait(1) >= 0) {}
+				}
+				release();
+			}
+
+			// false when io_uring isn't available (an old kernel, a seccomp filter), error() tells why
+			bool valid() const { return m_fd >= 0; }
+			int error() const { return m_error; }
+
+			// operations submitted or queued and not completed yet
+			size_t in_flight() const { return m_in_flight; }
+
+			// queues a pread of up to max elements at offset into the tail of vec. on completion vec grows by
+			// the whole elements read and on_complete(ssize_t result) runs, result being the bytes read or -errno.
+			// when the ring can't make room for it, it completes with -errno before read_append returns
+			template<typename Vec, typename F>
+			void read_append(int fd, Vec& vec, size_t max, off_t offset, F on_complete)
+			{
+				// whole elements only, so the tail isn't reserved beyond what can arrive
+				const auto most = max_transfer / sizeof(*vec.data());
+				if (max > most) max = most;
+
+				const auto iov = io::tail(vec, max);
+				auto o = new read_operation<Vec, F>(vec, std::move(on_complete));
+				queue(IORING_OP_READ, fd, iov.iov_base, iov.iov_len, offset, o);
+			}
+
+			// queues a pwrite of the elements of vec at offset. on_complete(ssize_t result) gets the bytes
+			// written or -errno, like read_append
+			template<typename Vec, typename F>
+			void write(int fd, const Vec& vec, off_t offset, F on_complete)
+			{
+				auto o = new write_operation<F>(vec.data(), std::move(on_complete));
+				queue(IORING_OP_WRITE, fd, const_cast<void*>(static_cast<const void*>(vec.data())), vec.size() * sizeof(*vec.data()), offset, o);
+			}
+
+			// hands the queued operations to the kernel. returns how many, or -errno
+			int submit()
+			{
+				return enter(0);
+			}
+
+			// submits, waits until at least min_complete operations completed and runs their completions
+			// returns how many ran, or -errno
+			int wait(unsigned min_complete = 1)
+			{
+				if (min_complete > m_in_flight) min_complete = unsigned(m_in_flight);
+
+				int done = reap();
+				while (unsigned(done) < min_complete)
+				{
+					const auto r = enter(min_complete - unsigned(done));
+					if (r < 0) return r;
+					done += reap();
+				}
+
+				// submit what the completions queued
+				const auto r = enter(0);
+				return r < 0 ? r : done;
+			}
+
+			// runs the completions that are ready, without waiting
+			int poll()
+			{
+				return reap();
+			}
+
+			// waits for everything in flight
+			int drain()
+			{
+				int done = 0;
+				while (m_in_flight)
+				{
+					const auto r = wait(unsigned(m_in_flight));
+					if (r < 0) return r;
+					done += r;
+				}
+				return done;
+			}
+
+#ifdef ML_SPV_URING_COROUTINES
+			// co_await ring.async_read_append(fd, vec, max, offset) resumes with the bytes read or -errno,
+			// from the wait() that saw the completion
+			template<typename Vec>
+			auto async_read_append(int fd, Vec& vec, size_t max, off_t offset)
+			{
+				struct awaiter
+				{
+					ring& r;
+					int fd;
+					Vec& vec;
+					size_t max;
+					off_t offset;
+					ssize_t result = 0;
+
+					bool await_ready() const noexcept { return false; }
+
+					void await_suspend(std::coroutine_handle<> h)
+					{
+						r.read_append(fd, vec, max, offset, [this, h](ssize_t res) { result = res; h.resume(); });
+					}
+
+					ssize_t await_resume() const noexcept { return result; }
+				};
+
+				return awaiter{ *this, fd, vec, max, offset };
+			}
+
+			// co_await ring.async_write(fd, vec, offset) resumes with the bytes written or -errno
+			template<typename Vec>
+			auto async_write(int fd, const Vec& vec, off_t offset)
+			{
+				struct awaiter
+				{
+					ring& r;
+					int fd;
+					const Vec& vec;
+					off_t offset;
+					ssize_t result = 0;
+
+					bool await_ready() const noexcept { return false; }
+
+					void await_suspend(std::coroutine_handle<> h)
+					{
+						r.write(fd, vec, offset, [this, h](ssize_t res) { result = res; h.resume(); });
+					}
+
+					ssize_t await_resume() const noexcept { return result; }
+				};
+
+				return awaiter{ *this, fd, vec, offset };
+			}
+#endif
+
+		private:
+			struct operation
+			{
+				virtual ~operation() = default;
+				virtual void complete(int result) = 0;
+			};
+
+			template<typename Vec, typename F>
+			struct read_operation : operation
+			{
+				read_operation(Vec& v, F&& f)
+					: vec(v)
+					, on_complete(std::move(f))
+					, size(v.size())
+				{
+					impl::pin(vec.data());
+				}
+
+				void complete(int result) override
+				{
+					impl::unpin(vec.data());
+
+					// the vector was left alone meanwhile
+					assert(vec.size() == size);
+
+					if (result > 0)
+					{
+						io::commit(vec, size_t(result));
+					}
+					on_complete(ssize_t(result));
+				}
+
+				Vec& vec;
+				F on_complete;
+				size_t size;
+			};
+
+			template<typename F>
+			struct write_operation : operation
+			{
+				write_operation(const void* d, F&& f)
+					: data(d)
+					, on_complete(std::move(f))
+				{
+					impl::pin(data);
+				}
+
+				void complete(int result) override
+				{
+					impl::unpin(data);
+					on_complete(ssize_t(result));
+				}
+
+				const void* data;
+				F on_complete;
+			};
+
+			void* map(size_t size, off_t offset)
+			{
+				auto p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, offset);
+				return p == MAP_FAILED ? nullptr : p;
+			}
+
+			void release()
+			{
+				if (m_sqes) ::munmap(m_sqes, m_sqes_size);
+				if (m_cq_ring && !m_single_mmap) ::munmap(m_cq_ring, m_cq_size);
+				if (m_sq_ring) ::munmap(m_sq_ring, m_sq_size);
+				if (m_fd >= 0) ::close(m_fd);
+
+				m_sqes = nullptr;
+				m_sq_ring = m_cq_ring = nullptr;
+				m_fd = -1;
+			}
+
+			void queue(uint8_t opcode, int fd, void* buffer, size_t bytes, off_t offset, operation* o)
+			{
+				assert(valid());
+
+				// every operation needs room for its completion, and the submission queue a free entry
+				while (m_in_flight >= m_cq_entries || m_queued == m_sq_entries)
+				{
+					const auto r = make_room();
+					if (r < 0)
+					{
+						// the ring can't take it, the operation completes with the error right away
+						o->complete(r);
+						delete o;
+						return;
+					}
+				}
+
+				const auto tail = *m_sq_tail;
+				const auto index = tail & m_sq_mask;
+
+				auto& sqe = m_sqes[index];
+				std::memset(&sqe, 0, sizeof(sqe));
+				sqe.opcode = opcode;
+				sqe.fd = fd;
+				sqe.addr = uint64_t(reinterpret_cast<uintptr_t>(buffer));
+				sqe.len = uint32_t(bytes < max_transfer ? bytes : max_transfer);
+				sqe.off = uint64_t(offset);
+				sqe.user_data = uint64_t(reinterpret_cast<uintptr_t>(o));
+
+				m_sq_array[index] = index;
+				__atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+				++m_queued;
+				++m_in_flight;
+			}
+
+			// submits the queued entries, or only waits with submit false, for min_complete completions
+			int enter(unsigned min_complete, bool submit = true)
+			{
+				const auto to_submit = submit ? m_queued : 0;
+				if (!to_submit && !min_complete) return 0;
+
+				int r;
+				do
+				{
+					r = int(::syscall(__NR_io_uring_enter, m_fd, to_submit, min_complete, min_complete ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+				} while (r < 0 && errno == EINTR);
+
+				if (r < 0) return -errno;
+
+				m_queued -= unsigned(r);
+				return r;
+			}
+
+			// submits, and waits for a completion when that isn't enough. the kernel may take part of the
+			// queue or, for now, none of it (EAGAIN, EBUSY): then the operations it has free the room as they
+			// complete. returns -errno when nothing it has will complete
+			int make_room()
+			{
+				int r = 0;
+				if (m_queued)
+				{
+					r = enter(0);
+					if (r < 0 && r != -EAGAIN && r != -EBUSY) return r;
+					if (r > 0 && m_in_flight < m_cq_entries) return r;
+				}
+
+				if (m_in_flight == m_queued) return r < 0 ? r : -EAGAIN;
+
+				r = enter(1, false);
+				return r < 0 ? r : reap();
+			}
+
+			// runs the completions that arrived. a completion may queue more and even wait, so the
+			// entry is consumed before it runs and the head is read again after
+			int reap()
+			{
+				int done = 0;
+
+				for (;;)
+				{
+					const auto head = *m_cq_head;
+					if (head == __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE)) break;
+
+					const auto cqe = m_cqes[head & m_cq_mask];
+					__atomic_store_n(m_cq_head, head + 1, __ATOMIC_RELEASE);
+
+					--m_in_flight;
+					++done;
+
+					auto o = reinterpret_cast<operation*>(uintptr_t(cqe.user_data));
+					o->complete(cqe.res);
+					delete o;
+				}
+
+				return done;
+			}
+
+			int m_fd = -1;
+			int m_error = 0;
+
+			void* m_sq_ring = nullptr;
+			void* m_cq_ring = nullptr;
+			io_uring_sqe* m_sqes = nullptr;
+			size_t m_sq_size = 0;
+			size_t m_cq_size = 0;
+			size_t m_sqes_size = 0;
+			bool m_single_mmap = false;
+
+			uint32_t* m_sq_tail = nullptr;
+			uint32_t* m_sq_array = nullptr;
+			uint32_t m_sq_mask = 0;
+			uint32_t m_sq_entries = 0;
+
+			uint32_t* m_cq_head = nullptr;
+			uint32_t* m_cq_tail = nullptr;
+			io_uring_cqe* m_cqes = nullptr;
+			uint32_t m_cq_mask = 0;
+			uint32_t m_cq_entries = 0;
+
+			unsigned m_queued = 0;
+			size_t m_in_flight = 0;
+		};
+	}
+
+}
+
+#endif
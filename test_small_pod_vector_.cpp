@@ -1,6 +1,10 @@
+#define ML_SPV_COUNT_COPIES
 
 #include "small_pod_vector.hpp"
 
+#include <vector>
+#include <string>
+
 TEST(TestCaseName, smallpod)
 {
 	{
@@ -849,4 +853,865 @@ TEST(TestCaseName, smallpod7)
 
 	EXPECT_EQ(mallocs, frees);
 
-}
\ No newline at end of file
+}
+
+int32_t reallocs = 0, expands = 0;
+
+struct reallocating_allocator : counting_allocator
+{
+	void* realloc(void* mem, size_type old_size, size_type new_size)
+	{
+		++reallocs;
+		return a.realloc(mem, old_size, new_size);
+	}
+};
+
+struct expanding_allocator : counting_allocator
+{
+	// pretends every block was allocated with room to spare
+	void* malloc(size_type)
+	{
+		return counting_allocator::malloc(1024);
+	}
+
+	bool try_expand_in_place(void*, size_type, size_type new_size)
+	{
+		if (new_size > 1024) return false;
+		++expands;
+		return true;
+	}
+};
+
+TEST(TestCaseName, smallpod9)
+{
+	mallocs = 0, frees = 0, reallocs = 0;
+	{
+		ml::small_pod_vector<int, 4, 0, reallocating_allocator> vec;
+
+		for (int i = 0; i < 100; ++i)
+		{
+			vec.push_back(i);
+		}
+
+		EXPECT_EQ(vec.size(), 100);
+		for (int i = 0; i < 100; ++i)
+		{
+			EXPECT_EQ(vec[i], i);
+		}
+
+		// only the first spill mallocs, all other growth goes through realloc
+		EXPECT_EQ(mallocs, 1);
+		EXPECT_GT(reallocs, 0);
+		EXPECT_EQ(frees, 0);
+
+		vec.shrink_to_fit();
+
+		EXPECT_EQ(vec.capacity(), 100);
+		EXPECT_EQ(vec.back(), 99);
+	}
+	EXPECT_EQ(mallocs, frees);
+
+	mallocs = 0, frees = 0, expands = 0;
+	{
+		ml::small_pod_vector<int, 4, 0, expanding_allocator> vec(5, 1);
+
+		const int* p = vec.data();
+
+		vec.insert(vec.begin(), { 1,2,3,4,5,6,7,8,9,10 });
+		vec.resize(100);
+
+		// grown in place, no copies
+		EXPECT_EQ(vec.data(), p);
+		EXPECT_EQ(mallocs, 1);
+		EXPECT_EQ(expands, 2);
+		EXPECT_EQ(vec[0], 1);
+		EXPECT_EQ(vec[14], 1);
+
+		// too big to expand, falls back to malloc + copy + free
+		vec.resize(1000);
+		EXPECT_NE(vec.data(), p);
+		EXPECT_EQ(mallocs, 2);
+		EXPECT_EQ(frees, 1);
+		EXPECT_EQ(vec[9], 10);
+	}
+	EXPECT_EQ(mallocs, frees);
+}
+
+
+int32_t sized_frees = 0;
+size_t live_bytes = 0;
+
+// hands out 64 byte size classes and wants the size back on free
+struct size_class_allocator
+{
+	ml::impl::pod_allocator a;
+
+	using size_type = size_t;
+
+	ml::impl::allocation_result allocate_at_least(size_type size)
+	{
+		++mallocs;
+		size = (size + 63) & ~size_type(63);
+		live_bytes += size;
+		return { a.malloc(size), size };
+	}
+
+	void free(void* mem, size_type size)
+	{
+		++sized_frees;
+		live_bytes -= size;
+		a.free(mem);
+	}
+};
+
+TEST(TestCaseName, smallpod10)
+{
+	mallocs = 0, sized_frees = 0, live_bytes = 0;
+	{
+		ml::small_pod_vector<int, 4, 0, size_class_allocator> vec;
+
+		for (int i = 0; i < 16; ++i)
+		{
+			vec.push_back(i);
+		}
+
+		// 5 + 4 ints were asked for, the size class holds 16
+		EXPECT_EQ(vec.capacity(), 16);
+		EXPECT_EQ(mallocs, 1);
+
+		vec.push_back(16);
+
+		EXPECT_EQ(vec.capacity(), 32);
+		EXPECT_EQ(mallocs, 2);
+		EXPECT_EQ(sized_frees, 1);
+		EXPECT_EQ(live_bytes, 128);
+
+		vec.erase(vec.begin() + 10, vec.end());
+		vec.shrink_to_fit();
+
+		EXPECT_EQ(vec.capacity(), 16);
+		EXPECT_EQ(vec.size(), 10);
+		EXPECT_EQ(vec.back(), 9);
+
+		ml::small_pod_vector<int, 4, 0, size_class_allocator> vec2(vec);
+
+		EXPECT_EQ(vec2.capacity(), 16);
+		EXPECT_EQ(vec2.back(), 9);
+	}
+	EXPECT_EQ(mallocs, sized_frees);
+	EXPECT_EQ(live_bytes, 0);
+}
+
+
+template <typename GrowthPolicy>
+using growth_vec = ml::small_pod_vector<int, 4, 0, counting_allocator, GrowthPolicy>;
+
+template <typename Vec>
+std::vector<size_t> capacities_of_push_backs(int n)
+{
+	Vec vec;
+	std::vector<size_t> caps;
+
+	for (int i = 0; i < n; ++i)
+	{
+		vec.push_back(i);
+		if (caps.empty() || caps.back() != vec.capacity())
+		{
+			caps.push_back(vec.capacity());
+		}
+	}
+	return caps;
+}
+
+// a user defined policy
+struct plus_ten
+{
+	static size_t spill_capacity(size_t static_capacity, size_t, size_t) { return static_capacity + 10; }
+	static size_t grow_capacity(size_t capacity, size_t required, size_t) { return capacity + 10 > required ? capacity + 10 : required; }
+};
+
+TEST(TestCaseName, smallpod11)
+{
+	EXPECT_EQ(capacities_of_push_backs<growth_vec<ml::growth::tight_spill>>(40), (std::vector<size_t>{ 4, 9, 18, 36, 72 }));
+	EXPECT_EQ(capacities_of_push_backs<growth_vec<ml::growth::doubling>>(40), (std::vector<size_t>{ 4, 8, 16, 32, 64 }));
+	EXPECT_EQ(capacities_of_push_backs<growth_vec<ml::growth::one_and_a_half>>(40), (std::vector<size_t>{ 4, 6, 9, 13, 19, 28, 42 }));
+	EXPECT_EQ(capacities_of_push_backs<growth_vec<ml::growth::page_rounded<64>>>(40), (std::vector<size_t>{ 4, 16, 32, 64 }));
+	EXPECT_EQ(capacities_of_push_backs<growth_vec<ml::growth::fixed_chunk<16>>>(40), (std::vector<size_t>{ 4, 16, 32, 48 }));
+	EXPECT_EQ(capacities_of_push_backs<growth_vec<plus_ten>>(40), (std::vector<size_t>{ 4, 14, 24, 34, 44 }));
+
+	mallocs = 0, frees = 0;
+	{
+		growth_vec<ml::growth::doubling> vec;
+
+		// a big insert gets what it needs
+		vec.resize(100);
+		EXPECT_EQ(vec.capacity(), 100);
+		EXPECT_EQ(mallocs, 1);
+
+		vec.push_back(2);
+		EXPECT_EQ(vec.capacity(), 200);
+		EXPECT_EQ(vec.back(), 2);
+	}
+	EXPECT_EQ(mallocs, frees);
+}
+
+
+#if INTPTR_MAX == INT64_MAX
+// begin, end, capacity, dynamic capacity and data, the empty allocator takes no space
+static_assert(sizeof(ml::small_pod_vector<int, 4>) == 40 + 4 * sizeof(int), "pointers layout header");
+// dynamic data, 32-bit size with the static/dynamic bit, 32-bit dynamic capacity
+static_assert(sizeof(ml::compact_small_pod_vector<int, 4>) == 16 + 4 * sizeof(int), "compact layout header");
+static_assert(sizeof(ml::small_pod_vector<int, 4, 0, ml::impl::pod_allocator, ml::growth::tight_spill, ml::layout::compact<size_t>>) == 24 + 4 * sizeof(int), "compact layout header with 64-bit sizes");
+static_assert(sizeof(ml::compact_small_pod_vector<uint8_t, 16>) == 32, "compact layout, half a cache line");
+// a stateful allocator is stored
+static_assert(sizeof(ml::small_pod_vector<int, 4, 0, reallocating_allocator>) > 40 + 4 * sizeof(int), "stateful allocator");
+#endif
+
+// applies the same random operations to the vector and a std::vector
+template <typename Vec>
+void compare_with_std_vector(unsigned seed)
+{
+	srand(seed);
+
+	Vec vec;
+	std::vector<int> ref;
+
+	for (int i = 0; i < 2000; ++i)
+	{
+		const int v = rand();
+		const size_t pos = ref.empty() ? 0 : size_t(rand()) % (ref.size() + 1);
+
+		switch (rand() % 12)
+		{
+		case 0:
+		case 1:
+		case 2:
+			vec.push_back(v);
+			ref.push_back(v);
+			break;
+		case 3:
+			vec.insert(vec.begin() + pos, v);
+			ref.insert(ref.begin() + pos, v);
+			break;
+		case 4:
+			vec.insert(vec.begin() + pos, { v, v + 1, v + 2, v + 3, v + 4, v + 5 });
+			ref.insert(ref.begin() + pos, { v, v + 1, v + 2, v + 3, v + 4, v + 5 });
+			break;
+		case 5:
+			if (pos < ref.size())
+			{
+				vec.erase(vec.begin() + pos);
+				ref.erase(ref.begin() + pos);
+			}
+			break;
+		case 6:
+		{
+			const size_t last = pos + size_t(rand()) % (ref.size() - pos + 1);
+			vec.erase(vec.begin() + pos, vec.begin() + last);
+			ref.erase(ref.begin() + pos, ref.begin() + last);
+			break;
+		}
+		case 7:
+		{
+			const size_t n = size_t(rand()) % 40;
+			const size_t old = ref.size();
+			vec.resize(n);
+			ref.resize(n);
+			for (size_t j = old; j < n; ++j)
+			{
+				vec[j] = ref[j] = v;
+			}
+			break;
+		}
+		case 8:
+			vec.shrink_to_fit();
+			break;
+		case 9:
+			if (rand() % 4 == 0)
+			{
+				vec.clear();
+				ref.clear();
+			}
+			else if (!ref.empty())
+			{
+				vec.pop_back();
+				ref.pop_back();
+			}
+			break;
+		case 10:
+		{
+			Vec copy(vec);
+			vec = std::move(copy);
+			break;
+		}
+		case 11:
+		{
+			Vec other(5, v);
+			other = vec;
+			vec = Vec();
+			vec = std::move(other);
+			break;
+		}
+		}
+
+		ASSERT_EQ(vec.size(), ref.size());
+		ASSERT_GE(vec.capacity(), vec.size());
+		ASSERT_TRUE(std::equal(ref.begin(), ref.end(), vec.begin()));
+	}
+}
+
+TEST(TestCaseName, smallpod12)
+{
+	for (unsigned seed = 0; seed < 10; ++seed)
+	{
+		compare_with_std_vector<ml::small_pod_vector<int, 4>>(seed);
+		compare_with_std_vector<ml::small_pod_vector<int, 8, 5>>(seed);
+		compare_with_std_vector<ml::small_pod_vector<int, 4, 0, reallocating_allocator>>(seed);
+		compare_with_std_vector<ml::compact_small_pod_vector<int, 4>>(seed);
+		compare_with_std_vector<ml::compact_small_pod_vector<int, 8, 9>>(seed);
+		compare_with_std_vector<ml::compact_small_pod_vector<int, 4, 3, size_class_allocator, ml::growth::doubling>>(seed);
+	}
+}
+
+#if INTPTR_MAX == INT64_MAX
+static_assert(sizeof(ml::sso_pod_vector<int>) == 32, "inline_union layout, object size");
+static_assert(ml::sso_pod_vector<int>::static_capacity == 7, "inline_union layout, ints in 32 bytes");
+static_assert(ml::sso_pod_vector<double>::static_capacity == 3, "inline_union layout, doubles in 32 bytes");
+static_assert(ml::sso_pod_vector<uint8_t>::static_capacity == 28, "inline_union layout, bytes in 32 bytes");
+static_assert(sizeof(ml::sso_pod_vector<uint8_t, 64>) == 64, "inline_union layout, a cache line");
+#endif
+
+template <typename T>
+using csso_vec = ml::small_pod_vector<T, 4, 3, counting_allocator, ml::growth::doubling, ml::layout::inline_union<>>;
+
+TEST(TestCaseName, smallpod13)
+{
+	mallocs = 0, frees = 0;
+	{
+		csso_vec<int> vec = { 1,2,3,4 };
+		EXPECT_EQ(vec.capacity(), 4);
+		EXPECT_EQ(mallocs, 0);
+
+		vec.push_back(5);
+		EXPECT_EQ(mallocs, 1);
+		EXPECT_EQ(vec.capacity(), 8);
+
+		// the heap pointer shares its bytes with the static buffer, so it can't be kept when reverting
+		vec.erase(vec.begin() + 1, vec.end() - 1);
+		EXPECT_EQ(vec.size(), 2);
+		EXPECT_EQ(vec.capacity(), 4);
+		EXPECT_EQ(frees, 1);
+		EXPECT_EQ(vec[0], 1);
+		EXPECT_EQ(vec[1], 5);
+
+		vec.reserve(10);
+		EXPECT_EQ(mallocs, 2);
+		EXPECT_GE(vec.capacity(), 10);
+		EXPECT_EQ(vec[1], 5);
+
+		csso_vec<int> moved(std::move(vec));
+		EXPECT_TRUE(vec.empty());
+		EXPECT_EQ(moved.size(), 2);
+		EXPECT_EQ(mallocs, 2);
+
+		moved.shrink_to_fit();
+		EXPECT_EQ(frees, 2);
+		EXPECT_EQ(moved.capacity(), 4);
+	}
+	EXPECT_EQ(mallocs, frees);
+
+	for (unsigned seed = 0; seed < 10; ++seed)
+	{
+		compare_with_std_vector<ml::sso_pod_vector<int>>(seed);
+		compare_with_std_vector<ml::sso_pod_vector<int, 24, size_class_allocator>>(seed);
+		compare_with_std_vector<csso_vec<int>>(seed);
+		compare_with_std_vector<ml::small_pod_vector<int, 4, 5, expanding_allocator, ml::growth::tight_spill, ml::layout::inline_union<>>>(seed);
+	}
+}
+
+template <typename Retention>
+using retaining_vec = ml::small_pod_vector<int, 4, 3, counting_allocator, ml::growth::tight_spill, ml::layout::pointers, Retention>;
+
+TEST(TestCaseName, smallpod14)
+{
+	mallocs = 0, frees = 0;
+	{
+		// the default keeps the buffer until the vector dies
+		retaining_vec<ml::retention::keep> vec(1000);
+		EXPECT_EQ(mallocs, 1);
+
+		vec.resize(2);
+		EXPECT_EQ(vec.capacity(), 4);
+		EXPECT_EQ(frees, 0);
+
+		vec.push_back(1);
+		vec.push_back(2);
+		vec.push_back(3);
+		EXPECT_EQ(mallocs, 1);
+
+		vec.clear();
+		EXPECT_EQ(frees, 0);
+
+		vec.release_spare();
+		EXPECT_EQ(frees, 1);
+
+		vec.release_spare();
+		EXPECT_EQ(frees, 1);
+	}
+	EXPECT_EQ(mallocs, frees);
+
+	mallocs = 0, frees = 0;
+	{
+		retaining_vec<ml::retention::release> vec(1000);
+		vec.erase(vec.begin() + 1, vec.end());
+		EXPECT_EQ(vec.size(), 1);
+		EXPECT_EQ(frees, 1);
+
+		// spilling again has to allocate
+		vec.resize(10);
+		EXPECT_EQ(mallocs, 2);
+		vec.clear();
+		EXPECT_EQ(frees, 2);
+
+		// nothing is kept after a reserve below the revert size either
+		vec.reserve(100);
+		EXPECT_EQ(mallocs, 3);
+		EXPECT_GE(vec.capacity(), 100);
+	}
+	EXPECT_EQ(mallocs, frees);
+
+	mallocs = 0, frees = 0;
+	{
+		using vec_type = retaining_vec<ml::retention::keep_below<64 * sizeof(int)>>;
+
+		vec_type small(10);
+		small.clear();
+		EXPECT_EQ(frees, 0);
+		small.resize(10);
+		EXPECT_EQ(mallocs, 1);
+
+		vec_type big(1000);
+		big.clear();
+		EXPECT_EQ(frees, 1);
+	}
+	EXPECT_EQ(mallocs, frees);
+
+	mallocs = 0, frees = 0;
+	{
+		// trim gives back what's not holding elements in one go
+		retaining_vec<ml::retention::keep> vec(1000);
+		vec.resize(100);
+		vec.trim();
+		EXPECT_EQ(vec.capacity(), 100);
+		// no realloc hook, so the shrunk buffer is a new one
+		EXPECT_EQ(mallocs, 2);
+		EXPECT_EQ(frees, 1);
+
+		vec.resize(2);
+		EXPECT_EQ(frees, 1);
+		vec.trim();
+		EXPECT_EQ(frees, 2);
+		EXPECT_EQ(vec.capacity(), 4);
+	}
+	EXPECT_EQ(mallocs, frees);
+
+	for (unsigned seed = 0; seed < 10; ++seed)
+	{
+		compare_with_std_vector<retaining_vec<ml::retention::release>>(seed);
+		compare_with_std_vector<ml::compact_small_pod_vector<int, 4, 5, ml::impl::pod_allocator, ml::growth::doubling, ml::retention::keep_below<64>>>(seed);
+	}
+}
+
+struct point
+{
+	int x, y;
+
+	point() = default;
+	point(int x_, int y_) : x(x_), y(y_) {}
+};
+
+TEST(TestCaseName, smallpod15)
+{
+	ml::small_pod_vector<point, 2> points;
+
+	auto& p = points.emplace_back(1, 2);
+	EXPECT_EQ(p.x, 1);
+	EXPECT_EQ(p.y, 2);
+	EXPECT_EQ(&p, &points.back());
+
+	points.emplace_back(3, 4);
+	auto& q = points.emplace_back(5, 6);
+	EXPECT_EQ(points.size(), 3);
+	EXPECT_EQ(&q, &points.back());
+	EXPECT_EQ(points[1].x, 3);
+	EXPECT_EQ(points[2].y, 6);
+
+	// the pushed value lives in the buffer that's being replaced
+	ml::small_pod_vector<int, 4> vec = { 1,2,3,4 };
+	vec.push_back(vec[0]);
+	vec.emplace_back(vec[1]);
+	for (int i = 0; i < 100; ++i)
+	{
+		vec.push_back(vec.back());
+	}
+	EXPECT_EQ(vec.size(), 106);
+	EXPECT_EQ(vec[4], 1);
+	EXPECT_EQ(vec[5], 2);
+	EXPECT_EQ(vec[105], 2);
+
+	mallocs = 0, frees = 0;
+	{
+		ml::small_pod_vector<int, 16, 0, counting_allocator> v;
+		v.reserve(100);
+		EXPECT_EQ(mallocs, 1);
+
+		for (int i = 0; i < 100; ++i)
+		{
+			v.push_back_unchecked(i);
+		}
+		EXPECT_EQ(mallocs, 1);
+		EXPECT_EQ(v.size(), 100);
+		EXPECT_EQ(v[99], 99);
+
+		ml::compact_small_pod_vector<int, 4> c;
+		c.reserve(10);
+		for (int i = 0; i < 10; ++i)
+		{
+			c.push_back_unchecked(i);
+		}
+		EXPECT_EQ(c[9], 9);
+	}
+	EXPECT_EQ(mallocs, frees);
+}
+
+TEST(TestCaseName, smallpod16)
+{
+	ml::small_pod_vector<uint8_t, 8> buf;
+
+	// a receive loop: append room, fill part of it, give the rest back
+	const char* packets[] = { "hello", " small", " pod vector" };
+	for (auto packet : packets)
+	{
+		const auto room = size_t(16);
+		auto tail = buf.append_uninitialized(room);
+		EXPECT_EQ(tail + room, buf.end());
+
+		const auto received = strlen(packet);
+		memcpy(tail, packet, received);
+		buf.resize(buf.size() - (room - received));
+	}
+	EXPECT_EQ(std::string(buf.begin(), buf.end()), "hello small pod vector");
+
+	buf.resize_and_overwrite(64, [](uint8_t* p, size_t n)
+	{
+		EXPECT_EQ(n, 64);
+		memcpy(p, "overwritten", 11);
+		return 11;
+	});
+	EXPECT_EQ(std::string(buf.begin(), buf.end()), "overwritten");
+
+	buf.resize_and_overwrite(3, [](uint8_t* p, size_t) { p[0] = 'a'; return 1; });
+	EXPECT_EQ(buf.size(), 1);
+	EXPECT_EQ(buf[0], 'a');
+
+	ml::small_pod_vector<int, 4> vec = { 1,2 };
+	vec.resize(6, 7);
+	EXPECT_EQ(vec.size(), 6);
+	EXPECT_EQ(vec[1], 2);
+	EXPECT_EQ(vec[2], 7);
+	EXPECT_EQ(vec[5], 7);
+
+	// the value is an element of the buffer that's being replaced
+	vec.resize(40, vec[0]);
+	EXPECT_EQ(vec[39], 1);
+	EXPECT_EQ(vec[5], 7);
+
+	vec.resize(2, 9);
+	EXPECT_EQ(vec.size(), 2);
+	EXPECT_EQ(vec[1], 2);
+
+	vec.resize_uninitialized(3);
+	EXPECT_EQ(vec.size(), 3);
+}
+
+TEST(TestCaseName, smallpod17)
+{
+	// uniform bytes go through memset, the others through the store loop
+	ml::small_pod_vector<int, 4> vec(10, -1);
+	EXPECT_EQ(std::count(vec.begin(), vec.end(), -1), 10);
+
+	vec.assign(20, 0x01020304);
+	EXPECT_EQ(vec.size(), 20);
+	EXPECT_EQ(std::count(vec.begin(), vec.end(), 0x01020304), 20);
+
+	vec.append_fill(5, 0);
+	EXPECT_EQ(vec.size(), 25);
+	EXPECT_EQ(vec[19], 0x01020304);
+	EXPECT_EQ(std::count(vec.begin() + 20, vec.end(), 0), 5);
+
+	// the value is an element and the buffer grows
+	vec.append_fill(100, vec[0]);
+	EXPECT_EQ(vec.size(), 125);
+	EXPECT_EQ(vec[124], 0x01020304);
+
+	auto it = vec.insert(vec.begin() + 1, 3, 7);
+	EXPECT_EQ(it, vec.begin() + 1);
+	EXPECT_EQ(vec.size(), 128);
+	EXPECT_EQ(vec[0], 0x01020304);
+	EXPECT_EQ(vec[1], 7);
+	EXPECT_EQ(vec[3], 7);
+	EXPECT_EQ(vec[4], 0x01020304);
+
+	vec.insert(vec.begin(), 2, vec[1]);
+	EXPECT_EQ(vec[0], 7);
+	EXPECT_EQ(vec[1], 7);
+	EXPECT_EQ(vec[2], 0x01020304);
+
+	vec.insert(vec.end(), 0, 5);
+	EXPECT_EQ(vec.size(), 130);
+
+	ml::small_pod_vector<double, 4> d;
+	d.append_fill(9, 0.0);
+	d.append_fill(9, 1.5);
+	EXPECT_EQ(d[8], 0.0);
+	EXPECT_EQ(d[17], 1.5);
+
+	struct point { int16_t x; int16_t y; int16_t z; };
+	ml::small_pod_vector<point, 2> points;
+	points.insert(points.begin(), 5, point{ 1, 2, 3 });
+	points.insert(points.begin() + 2, 1, point{ 0x0101, 0x0101, 0x0101 });
+	EXPECT_EQ(points.size(), 6);
+	EXPECT_EQ(points[5].z, 3);
+	EXPECT_EQ(points[2].y, 0x0101);
+
+	std::vector<int> ref(10, 3);
+	ml::small_pod_vector<int, 4> pod(10, 3);
+	ref.insert(ref.begin() + 4, 6, 8);
+	pod.insert(pod.begin() + 4, 6, 8);
+	EXPECT_TRUE(std::equal(ref.begin(), ref.end(), pod.begin(), pod.end()));
+}
+
+TEST(TestCaseName, smallpod18)
+{
+	using vec_type = growth_vec<ml::growth::doubling>;
+
+	vec_type vec;
+	for (int i = 0; i < 64; ++i)
+	{
+		vec.push_back(i);
+	}
+	ASSERT_EQ(vec.capacity(), vec.size());
+
+	// the full buffer grows around the hole, each element is copied once
+	auto before = ml::impl::bytes_copied();
+	vec.insert(vec.begin() + 10, -1);
+	EXPECT_EQ(ml::impl::bytes_copied() - before, 64 * sizeof(int));
+	EXPECT_EQ(vec.size(), 65);
+	EXPECT_EQ(vec[9], 9);
+	EXPECT_EQ(vec[10], -1);
+	EXPECT_EQ(vec[11], 10);
+	EXPECT_EQ(vec[64], 63);
+
+	// only the live elements move, not the capacity
+	vec.resize(3);
+	before = ml::impl::bytes_copied();
+	vec.reserve(1000);
+	EXPECT_EQ(ml::impl::bytes_copied() - before, 3 * sizeof(int));
+	EXPECT_EQ(vec[2], 2);
+
+	// an in place insert shifts the tail
+	before = ml::impl::bytes_copied();
+	vec.insert(vec.begin() + 1, 2, 7);
+	EXPECT_EQ(ml::impl::bytes_copied() - before, 2 * sizeof(int));
+	EXPECT_EQ(vec[3], 1);
+	EXPECT_EQ(vec[4], 2);
+
+	// a realloc that moves copies the old block
+	ml::small_pod_vector<int, 4> rvec(100, 1);
+	before = ml::impl::bytes_copied();
+	rvec.push_back(2);
+	EXPECT_LE(ml::impl::bytes_copied() - before, rvec.capacity() * sizeof(int));
+	EXPECT_EQ(rvec.back(), 2);
+}
+
+template <typename Vec>
+void check_many(unsigned seed)
+{
+	std::srand(seed);
+
+	Vec vec;
+	std::vector<int> ref;
+	int next = 0;
+
+	for (int round = 0; round < 50; ++round)
+	{
+		// a sorted patch list, some positions repeated
+		const size_t k = size_t(std::rand() % 6);
+		std::vector<size_t> at(k);
+		for (auto& a : at)
+		{
+			a = ref.empty() ? 0 : size_t(std::rand()) % (ref.size() + 1);
+		}
+		std::sort(at.begin(), at.end());
+
+		std::vector<std::vector<int>> values(k);
+		std::vector<typename Vec::insertion> ranges;
+		for (size_t i = 0; i < k; ++i)
+		{
+			values[i].resize(size_t(std::rand() % 5));
+			for (auto& v : values[i])
+			{
+				v = next++;
+			}
+			ranges.push_back({ vec.cbegin() + at[i], values[i].data(), values[i].data() + values[i].size() });
+		}
+
+		for (size_t i = k; i-- > 0;)
+		{
+			ref.insert(ref.begin() + at[i], values[i].begin(), values[i].end());
+		}
+		vec.insert_many(ranges.data(), ranges.size());
+		ASSERT_TRUE(std::equal(vec.begin(), vec.end(), ref.begin(), ref.end()));
+
+		// sorted erasures, every other round
+		if (round % 2)
+		{
+			std::vector<typename Vec::erasure> erasures;
+			size_t pos = 0;
+			while (pos < ref.size())
+			{
+				const auto first = pos + size_t(std::rand() % 4);
+				const auto last = std::min(ref.size(), first + size_t(std::rand() % 3));
+				if (first >= last) break;
+				erasures.push_back({ vec.cbegin() + first, vec.cbegin() + last });
+				pos = last;
+			}
+
+			for (size_t i = erasures.size(); i-- > 0;)
+			{
+				ref.erase(ref.begin() + (erasures[i].first - vec.cbegin()), ref.begin() + (erasures[i].last - vec.cbegin()));
+			}
+			vec.erase_many(erasures.data(), erasures.size());
+			ASSERT_TRUE(std::equal(vec.begin(), vec.end(), ref.begin(), ref.end()));
+		}
+	}
+}
+
+TEST(TestCaseName, smallpod19)
+{
+	for (unsigned seed = 0; seed < 20; ++seed)
+	{
+		check_many<ml::small_pod_vector<int, 8>>(seed);
+		check_many<ml::small_pod_vector<int, 8, 5>>(seed);
+		check_many<ml::small_pod_vector<int, 8, 5, ml::impl::pod_allocator, ml::growth::doubling, ml::layout::compact<>, ml::retention::release>>(seed);
+		check_many<ml::sso_pod_vector<int, 32>>(seed);
+		check_many<csso_vec<int>>(seed);
+	}
+
+	using vec_type = growth_vec<ml::growth::doubling>;
+
+	vec_type vec;
+	for (int i = 0; i < 64; ++i)
+	{
+		vec.push_back(i);
+	}
+	ASSERT_EQ(vec.capacity(), vec.size());
+
+	// three ranges into a full buffer: one allocation, each element copied once
+	const int a[] = { -1, -2 };
+	const int b[] = { -3 };
+	const int c[] = { -4, -5, -6 };
+	auto before = ml::impl::bytes_copied();
+	const auto mallocs_before = mallocs;
+	vec.insert_many({ { vec.begin(), a, a + 2 }, { vec.begin() + 32, b, b + 1 }, { vec.end(), c, c + 3 } });
+	EXPECT_EQ(ml::impl::bytes_copied() - before, 64 * sizeof(int));
+	EXPECT_EQ(mallocs - mallocs_before, 1);
+	EXPECT_EQ(vec.size(), 70);
+	EXPECT_EQ(vec[0], -1);
+	EXPECT_EQ(vec[2], 0);
+	EXPECT_EQ(vec[34], -3);
+	EXPECT_EQ(vec[35], 32);
+	EXPECT_EQ(vec[66], 63);
+	EXPECT_EQ(vec[69], -6);
+
+	// in place, only the tails behind the ranges move
+	vec.resize(10);
+	for (int i = 0; i < 10; ++i)
+	{
+		vec[i] = i;
+	}
+	before = ml::impl::bytes_copied();
+	vec.insert_many({ { vec.begin() + 5, a, a + 2 }, { vec.begin() + 8, b, b + 1 } });
+	EXPECT_EQ(ml::impl::bytes_copied() - before, 5 * sizeof(int));
+	EXPECT_EQ(vec[5], -1);
+	EXPECT_EQ(vec[7], 5);
+	EXPECT_EQ(vec[10], -3);
+	EXPECT_EQ(vec[12], 9);
+
+	// erasing by position, the front stays put
+	const vec_type::const_iterator positions[] = { vec.begin() + 5, vec.begin() + 6, vec.begin() + 10 };
+	before = ml::impl::bytes_copied();
+	vec.erase_many(positions, 3);
+	EXPECT_EQ(ml::impl::bytes_copied() - before, 5 * sizeof(int));
+	EXPECT_EQ(vec.size(), 10);
+	for (int i = 0; i < 10; ++i)
+	{
+		EXPECT_EQ(vec[i], i);
+	}
+}
+
+TEST(TestCaseName, smallpod20)
+{
+	// below the revert size reserve() keeps the static buffer, reserve_writable() doesn't
+	ml::small_pod_vector<int, 4, 3> vec = { 1, 2 };
+	vec.reserve(100);
+	EXPECT_EQ(vec.capacity(), 4);
+
+	vec.reserve_writable(100);
+	EXPECT_GE(vec.capacity(), 100);
+	EXPECT_EQ(vec.size(), 2);
+	EXPECT_EQ(vec[1], 2);
+
+	int* p = vec.data();
+	for (int i = 2; i < 100; ++i)
+	{
+		p[i] = i + 1;
+	}
+	vec.resize_uninitialized(100);
+	EXPECT_EQ(vec.data(), p);
+	EXPECT_EQ(vec.back(), 100);
+
+	// already writable, nothing moves
+	vec.reserve_writable(50);
+	EXPECT_EQ(vec.data(), p);
+
+	ml::small_pod_vector<int, 4> plain = { 1 };
+	plain.reserve_writable(3);
+	EXPECT_EQ(plain.capacity(), 4);
+	plain.reserve_writable(10);
+	EXPECT_GE(plain.capacity(), 10);
+	EXPECT_EQ(plain[0], 1);
+}
+
+TEST(TestCaseName, smallpod21)
+{
+	// elements written past size() are kept below the revert size, resize_uninitialized() would drop them
+	ml::small_pod_vector<int, 8, 5> vec = { 7 };
+	vec.reserve_writable(16);
+	vec.data()[1] = 41;
+	vec.data()[2] = 42;
+	vec.commit_uninitialized(2);
+
+	ASSERT_EQ(vec.size(), 3);
+	EXPECT_EQ(vec[0], 7);
+	EXPECT_EQ(vec[1], 41);
+	EXPECT_EQ(vec[2], 42);
+
+	// in the static buffer too
+	ml::small_pod_vector<int, 8, 5> small;
+	small.data()[0] = 1;
+	small.commit_uninitialized(1);
+	EXPECT_EQ(small.size(), 1);
+	EXPECT_EQ(small[0], 1);
+	EXPECT_EQ(small.capacity(), 8);
+}
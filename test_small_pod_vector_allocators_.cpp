@@ -0,0 +1,298 @@
+#include "small_pod_vector_allocators.hpp"
+
+#include <thread>
+#include <vector>
+
+template <typename T>
+using poolvec = ml::small_pod_vector<T, 4, 0, ml::impl::pool_allocator>;
+
+TEST(TestCaseName, pool1)
+{
+	const auto before = ml::impl::pool_allocator::stats();
+
+	const int* first = nullptr;
+	{
+		poolvec<int> vec{ 1,2,3,4,5 };
+
+		// 9 ints asked for, served from the 64 byte class
+		EXPECT_EQ(vec.capacity(), 16);
+		first = vec.data();
+	}
+
+	for (int i = 0; i < 100; ++i)
+	{
+		poolvec<int> vec{ 1,2,3,4,5 };
+
+		// the block is recycled
+		EXPECT_EQ(vec.data(), first);
+		EXPECT_EQ(vec.back(), 5);
+	}
+
+	{
+		poolvec<int> vec;
+		for (int i = 0; i < 1000; ++i)
+		{
+			vec.push_back(i);
+		}
+
+		EXPECT_EQ(vec.size(), 1000);
+		EXPECT_EQ(vec[999], 999);
+	}
+
+	const auto after = ml::impl::pool_allocator::stats();
+
+	// the 100 vectors above and the first spill of the growing one
+	EXPECT_EQ(after.pool_hits - before.pool_hits, 101);
+	EXPECT_EQ(after.allocations - before.allocations, after.frees - before.frees);
+	EXPECT_EQ(after.remote_frees, before.remote_frees);
+	EXPECT_GT(after.cached_bytes, before.cached_bytes);
+
+	{
+		// too big for any size class
+		poolvec<char> vec(ml::impl::pool_allocator::max_block_size + 1);
+		EXPECT_GT(vec.capacity(), ml::impl::pool_allocator::max_block_size);
+	}
+
+	const auto big = ml::impl::pool_allocator::stats();
+
+	EXPECT_EQ(big.system_allocations - after.system_allocations, 1);
+	EXPECT_EQ(big.system_frees - after.system_frees, 1);
+}
+
+TEST(TestCaseName, pool2)
+{
+	// this thread needs a heap of its own first, or it would adopt the worker's once that's parked
+	ml::impl::pool_allocator::free(ml::impl::pool_allocator::malloc(1));
+
+	const auto before = ml::impl::pool_allocator::stats();
+
+	std::vector<poolvec<int>> produced;
+
+	// blocks allocated by the worker, freed here
+	std::thread([&produced]()
+	{
+		for (int i = 0; i < 10; ++i)
+		{
+			produced.emplace_back(poolvec<int>{ 1,2,3,4,5,6 });
+		}
+	}).join();
+
+	produced.clear();
+
+	const auto after = ml::impl::pool_allocator::stats();
+
+	EXPECT_EQ(after.remote_frees - before.remote_frees, 10);
+
+	// the worker's heap was parked with the blocks on its remote list, the next thread adopts it
+	std::thread([]()
+	{
+		for (int i = 0; i < 10; ++i)
+		{
+			poolvec<int> vec{ 1,2,3,4,5,6 };
+			EXPECT_EQ(vec.front(), 1);
+		}
+	}).join();
+
+	const auto adopted = ml::impl::pool_allocator::stats();
+
+	EXPECT_EQ(adopted.pool_hits - after.pool_hits, 10);
+	EXPECT_EQ(adopted.system_allocations, after.system_allocations);
+}
+
+TEST(TestCaseName, pool3)
+{
+	// producers hand their vectors to each other while allocating
+	std::vector<std::thread> threads;
+	std::vector<std::vector<poolvec<int>>> out(4);
+
+	for (size_t t = 0; t < out.size(); ++t)
+	{
+		threads.emplace_back([t, &out]()
+		{
+			for (int i = 0; i < 1000; ++i)
+			{
+				poolvec<int> vec;
+				for (int j = 0; j < i % 50; ++j)
+				{
+					vec.push_back(j);
+				}
+				if (i % 10 == 0)
+				{
+					out[t].push_back(std::move(vec));
+				}
+			}
+		});
+	}
+
+	for (auto& t : threads)
+	{
+		t.join();
+	}
+
+	std::thread([&out]()
+	{
+		for (auto& v : out)
+		{
+			for (auto& vec : v)
+			{
+				for (size_t j = 0; j < vec.size(); ++j)
+				{
+					EXPECT_EQ(vec[j], int(j));
+				}
+			}
+			v.clear();
+		}
+	}).join();
+}
+
+template <typename T>
+using arenavec = ml::small_pod_vector<T, 4, 0, ml::impl::arena_allocator>;
+
+TEST(TestCaseName, arena1)
+{
+	ml::impl::arena arena(4096);
+
+	{
+		arenavec<int> vec(arena);
+
+		vec.push_back(0);
+		for (int i = 1; i < 5; ++i)
+		{
+			vec.push_back(i);
+		}
+
+		const int* p = vec.data();
+
+		// the last allocation grows in place
+		for (int i = 5; i < 500; ++i)
+		{
+			vec.push_back(i);
+		}
+
+		EXPECT_EQ(vec.data(), p);
+		EXPECT_EQ(vec.size(), 500);
+		EXPECT_EQ(vec[499], 499);
+		EXPECT_EQ(arena.bytes_reserved(), 4096);
+
+		// another allocation in between, so this one has to move
+		arenavec<int> vec2({ 1,2,3,4,5,6 }, arena);
+
+		for (int i = 500; i < 600; ++i)
+		{
+			vec.push_back(i);
+		}
+
+		EXPECT_NE(vec.data(), p);
+		EXPECT_EQ(vec[599], 599);
+		EXPECT_EQ(vec[0], 0);
+		EXPECT_EQ(vec2.back(), 6);
+
+		const auto used = arena.bytes_used();
+
+		vec.clear();
+		vec.shrink_to_fit();
+
+		// free is a no-op
+		EXPECT_EQ(arena.bytes_used(), used);
+		EXPECT_EQ(vec.get_allocator().get_arena().bytes_used(), used);
+	}
+
+	const auto reserved = arena.bytes_reserved();
+
+	// keeps the last chunk
+	arena.reset();
+
+	EXPECT_EQ(arena.bytes_used(), 0);
+	EXPECT_GT(arena.bytes_reserved(), 0);
+	EXPECT_LT(arena.bytes_reserved(), reserved);
+
+	{
+		// bigger than a chunk
+		arenavec<char> vec(10000, 'a', arena);
+		EXPECT_EQ(vec.back(), 'a');
+		EXPECT_GE(arena.bytes_reserved(), 10000);
+	}
+
+	arena.release();
+
+	EXPECT_EQ(arena.bytes_reserved(), 0);
+}
+
+#if defined(__linux__)
+template <typename T, unsigned Options>
+using mmapvec = ml::small_pod_vector<T, 4, 0, ml::impl::mmap_allocator<64 * 1024, Options>, ml::growth::doubling>;
+
+TEST(TestCaseName, mmap1)
+{
+	using alloc = ml::impl::mmap_allocator<64 * 1024, ml::impl::mmap_options::none>;
+
+	{
+		mmapvec<uint32_t, ml::impl::mmap_options::none> vec;
+
+		// below the threshold it's std::malloc
+		for (uint32_t i = 0; i < 1000; ++i)
+		{
+			vec.push_back(i);
+		}
+		EXPECT_EQ(alloc::stats().maps, 0);
+
+		// above, a mapping grown by mremap
+		for (uint32_t i = 1000; i < 1000000; ++i)
+		{
+			vec.push_back(i);
+		}
+		for (uint32_t i = 0; i < 1000000; ++i)
+		{
+			ASSERT_EQ(vec[i], i);
+		}
+
+		const auto s = alloc::stats();
+		EXPECT_EQ(s.maps, 1);
+		EXPECT_GT(s.remaps, 0);
+		EXPECT_GE(s.mapped_bytes, vec.capacity() * sizeof(uint32_t));
+		EXPECT_EQ(s.mapped_bytes % 4096, 0);
+
+		// back under the threshold, copied out of the mapping
+		vec.resize(10);
+		vec.shrink_to_fit();
+		EXPECT_EQ(vec[9], 9);
+		EXPECT_EQ(alloc::stats().mapped_bytes, 0);
+
+		vec.resize(100000, 7);
+		EXPECT_EQ(alloc::stats().maps, 2);
+	}
+
+	const auto s = alloc::stats();
+	EXPECT_EQ(s.maps, s.unmaps);
+	EXPECT_EQ(s.mapped_bytes, 0);
+}
+
+TEST(TestCaseName, mmap2)
+{
+	using huge = ml::impl::mmap_allocator<64 * 1024, ml::impl::mmap_options::huge_pages | ml::impl::mmap_options::populate>;
+	using hugetlb = ml::impl::mmap_allocator<64 * 1024, ml::impl::mmap_options::hugetlb>;
+
+	{
+		mmapvec<char, ml::impl::mmap_options::huge_pages | ml::impl::mmap_options::populate> vec(100000, 'a');
+
+		// whole, aligned huge pages
+		EXPECT_EQ(vec.capacity(), huge::huge_page_size);
+		EXPECT_EQ(reinterpret_cast<uintptr_t>(vec.data()) % huge::huge_page_size, 0);
+
+		vec.resize(3 * huge::huge_page_size, 'b');
+		EXPECT_EQ(vec[99999], 'a');
+		EXPECT_EQ(vec[100000], 'b');
+		EXPECT_EQ(huge::stats().mapped_bytes, 3 * huge::huge_page_size);
+
+		// works whether or not huge pages are reserved
+		mmapvec<char, ml::impl::mmap_options::hugetlb> tlb(100000, 'c');
+		tlb.resize(5 * huge::huge_page_size, 'd');
+		EXPECT_EQ(tlb[0], 'c');
+		EXPECT_EQ(tlb.back(), 'd');
+		EXPECT_EQ(hugetlb::stats().maps - hugetlb::stats().unmaps, 1);
+	}
+
+	EXPECT_EQ(huge::stats().mapped_bytes, 0);
+	EXPECT_EQ(hugetlb::stats().mapped_bytes, 0);
+}
+#endif
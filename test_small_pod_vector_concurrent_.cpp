@@ -0,0 +1,113 @@
+#include "small_pod_vector_concurrent.hpp"
+#include "small_pod_vector_allocators.hpp"
+
+#include <thread>
+#include <vector>
+
+TEST(TestCaseName, concurrent1)
+{
+	using math = ml::impl::segment_math<4>;
+
+	EXPECT_EQ(math::segment_of(0), 0);
+	EXPECT_EQ(math::segment_of(3), 0);
+	EXPECT_EQ(math::segment_of(4), 1);
+	EXPECT_EQ(math::segment_of(7), 1);
+	EXPECT_EQ(math::segment_of(8), 2);
+	EXPECT_EQ(math::segment_of(15), 2);
+	EXPECT_EQ(math::segment_of(16), 3);
+	EXPECT_EQ(math::segment_begin(3), 16);
+	EXPECT_EQ(math::segment_size(3), 16);
+
+	// not a power of two
+	using odd = ml::impl::segment_math<3>;
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		const auto k = odd::segment_of(i);
+		EXPECT_GE(i, odd::segment_begin(k));
+		EXPECT_LT(i, odd::segment_begin(k) + odd::segment_size(k));
+	}
+
+	ml::concurrent_pod_vector<int, 4> vec;
+	for (int i = 0; i < 100; ++i)
+	{
+		vec.push_back(i);
+	}
+
+	// a run across segment boundaries
+	int run[50];
+	for (int i = 0; i < 50; ++i)
+	{
+		run[i] = 100 + i;
+	}
+	EXPECT_EQ(vec.append(run, 50), 100);
+	EXPECT_EQ(vec.emplace_back(150), 150);
+
+	EXPECT_EQ(vec.size(), 151);
+	for (int i = 0; i < 151; ++i)
+	{
+		EXPECT_EQ(vec[i], i);
+	}
+
+	size_t segments = 0;
+	vec.for_each_segment([&](const int* p, size_t n) { EXPECT_GT(n, 0); EXPECT_NE(p, nullptr); ++segments; });
+	EXPECT_EQ(segments, 7);
+
+	auto flat = vec.to_vector();
+	EXPECT_EQ(flat.size(), 151);
+	EXPECT_EQ(flat[150], 150);
+
+	ml::small_pod_vector<int, 4> existing = { -1 };
+	vec.append_to(existing);
+	EXPECT_EQ(existing.size(), 152);
+	EXPECT_EQ(existing[1], 0);
+
+	vec.clear();
+	EXPECT_TRUE(vec.empty());
+	vec.push_back(7);
+	EXPECT_EQ(vec[0], 7);
+	EXPECT_EQ(vec.to_vector().capacity(), 4);
+}
+
+TEST(TestCaseName, concurrent2)
+{
+	ml::concurrent_pod_vector<uint32_t, 16, ml::impl::pool_allocator> vec;
+
+	const uint32_t threads = 8;
+	const uint32_t per_thread = 20000;
+
+	std::vector<std::thread> workers;
+	for (uint32_t t = 0; t < threads; ++t)
+	{
+		workers.emplace_back([t, &vec]()
+		{
+			for (uint32_t i = 0; i < per_thread; ++i)
+			{
+				if (i % 100 == 0)
+				{
+					uint32_t run[3] = { t * per_thread + i, t * per_thread + i + 1, t * per_thread + i + 2 };
+					vec.append(run, 3);
+					i += 2;
+				}
+				else
+				{
+					vec.push_back(t * per_thread + i);
+				}
+			}
+		});
+	}
+
+	for (auto& w : workers)
+	{
+		w.join();
+	}
+
+	// every value exactly once
+	const auto flat = vec.to_vector();
+	std::vector<uint32_t> all(flat.begin(), flat.end());
+	ASSERT_EQ(all.size(), threads * per_thread);
+	std::sort(all.begin(), all.end());
+	for (uint32_t i = 0; i < all.size(); ++i)
+	{
+		ASSERT_EQ(all[i], i);
+	}
+}
@@ -0,0 +1,202 @@
+#include "small_pod_vector_flat.hpp"
+
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+TEST(TestCaseName, flat1)
+{
+	ml::small_flat_set<int, 8> set = { 5, 3, 9, 3, 1, 5 };
+	EXPECT_EQ(set.size(), 4);
+	EXPECT_EQ(set.capacity(), 8);
+	EXPECT_TRUE(std::is_sorted(set.begin(), set.end()));
+
+	EXPECT_TRUE(set.contains(9));
+	EXPECT_FALSE(set.contains(4));
+	EXPECT_EQ(set.count(3), 1);
+	EXPECT_EQ(set.find(4), set.end());
+	EXPECT_EQ(*set.lower_bound(4), 5);
+	EXPECT_EQ(*set.upper_bound(5), 9);
+	EXPECT_EQ(set.lower_bound(10), set.end());
+	EXPECT_EQ(set.equal_range(3).second - set.equal_range(3).first, 1);
+	EXPECT_EQ(set.equal_range(4).second - set.equal_range(4).first, 0);
+
+	EXPECT_TRUE(set.insert(4).second);
+	EXPECT_FALSE(set.insert(4).second);
+	EXPECT_EQ(*set.insert(0).first, 0);
+	EXPECT_EQ(set, (ml::small_flat_set<int, 8>{ 0, 1, 3, 4, 5, 9 }));
+
+	EXPECT_EQ(set.erase(3), 1);
+	EXPECT_EQ(set.erase(3), 0);
+	EXPECT_EQ(*set.erase(set.find(4)), 5);
+	EXPECT_EQ(set, (ml::small_flat_set<int, 8>{ 0, 1, 5, 9 }));
+
+	// still in the static buffer
+	EXPECT_EQ(set.capacity(), 8);
+
+	// a range appended, sorted once
+	std::vector<int> more = { 20, 2, 9, 7, 20, 11 };
+	set.insert(more.begin(), more.end());
+	EXPECT_EQ(set, (ml::small_flat_set<int, 8>{ 0, 1, 2, 5, 7, 9, 11, 20 }));
+
+	ml::small_flat_set<int, 4, std::greater<int>> down = { 1, 7, 3 };
+	EXPECT_EQ(*down.begin(), 7);
+	EXPECT_EQ(*down.lower_bound(5), 3);
+	EXPECT_TRUE(down.contains(1));
+}
+
+TEST(TestCaseName, flat2)
+{
+	ml::small_flat_map<int, double, 4> map = { { 3, 0.3 }, { 1, 0.1 }, { 2, 0.2 }, { 1, 9.0 } };
+	EXPECT_EQ(map.size(), 3);
+
+	// the first value of a repeated key is kept
+	EXPECT_EQ(map.at(1), 0.1);
+	EXPECT_EQ(map.get(4), nullptr);
+	EXPECT_EQ(*map.get(2), 0.2);
+
+	EXPECT_EQ(map.keys()[0], 1);
+	EXPECT_EQ(map.keys()[2], 3);
+	EXPECT_EQ(map.values()[2], 0.3);
+
+	map[0] = 1.5;
+	EXPECT_EQ(map.size(), 4);
+	EXPECT_EQ(map.begin()->first, 0);
+	EXPECT_EQ(map.begin()->second, 1.5);
+	EXPECT_EQ(map[5], 0.0);
+	EXPECT_EQ(map.size(), 5);
+
+	EXPECT_FALSE(map.try_emplace(5, 2.0).second);
+	EXPECT_EQ(map.at(5), 0.0);
+	EXPECT_FALSE(map.insert_or_assign(5, 2.0).second);
+	EXPECT_EQ(map.at(5), 2.0);
+	EXPECT_TRUE(map.insert({ 4, 4.0 }).second);
+
+	std::vector<int> keys;
+	for (auto kv : map)
+	{
+		keys.push_back(kv.first);
+		kv.second += 1;
+	}
+	EXPECT_EQ(keys, (std::vector<int>{ 0, 1, 2, 3, 4, 5 }));
+	EXPECT_EQ(map.at(4), 5.0);
+
+	EXPECT_EQ(map.find(7), map.end());
+	EXPECT_EQ((*map.find(3)).second, 1.3);
+	EXPECT_EQ(map.lower_bound(3) - map.begin(), 3);
+	EXPECT_EQ(map.upper_bound(3) - map.begin(), 4);
+
+	EXPECT_EQ(map.erase(2), 1);
+	EXPECT_EQ(map.erase(2), 0);
+	auto it = map.erase(map.cbegin());
+	EXPECT_EQ(it->first, 1);
+	EXPECT_EQ(map.size(), 4);
+
+	// a range with keys already there keeps the old values
+	std::vector<std::pair<int, double>> more = { { 9, 9.0 }, { 1, 0.0 }, { 6, 6.0 } };
+	map.insert(more.begin(), more.end());
+	EXPECT_EQ(map.size(), 6);
+	EXPECT_EQ(map.at(1), 1.1);
+	EXPECT_EQ(map.at(9), 9.0);
+	EXPECT_TRUE(std::is_sorted(map.keys(), map.keys() + map.size()));
+
+	const auto& cmap = map;
+	ml::small_flat_map<int, double, 4>::const_iterator cit = map.begin();
+	EXPECT_EQ(cit, cmap.begin());
+	EXPECT_EQ(*cmap.get(6), 6.0);
+
+	map.clear();
+	EXPECT_TRUE(map.empty());
+}
+
+// random operations against std::set / std::map, both lookup paths
+template<typename Set, typename Map>
+void check_flat(unsigned seed, int range)
+{
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> key(0, range);
+
+	Set set;
+	Map map;
+	std::set<int> ref_set;
+	std::map<int, int> ref_map;
+
+	for (int i = 0; i < 2000; ++i)
+	{
+		const auto k = key(rng);
+		switch (rng() % 4)
+		{
+		case 0:
+		case 1:
+			EXPECT_EQ(set.insert(k).second, ref_set.insert(k).second);
+			EXPECT_EQ(map.try_emplace(k, i).second, ref_map.emplace(k, i).second);
+			break;
+		case 2:
+			EXPECT_EQ(set.erase(k), ref_set.erase(k));
+			EXPECT_EQ(map.erase(k), ref_map.erase(k));
+			break;
+		default:
+			EXPECT_EQ(set.contains(k), ref_set.count(k) == 1);
+			EXPECT_EQ(set.lower_bound(k) - set.begin(), std::distance(ref_set.begin(), ref_set.lower_bound(k)));
+			EXPECT_EQ(set.upper_bound(k) - set.begin(), std::distance(ref_set.begin(), ref_set.upper_bound(k)));
+			EXPECT_EQ(map.get(k) != nullptr, ref_map.count(k) == 1);
+			if (map.get(k))
+			{
+				EXPECT_EQ(*map.get(k), ref_map[k]);
+			}
+			break;
+		}
+	}
+
+	EXPECT_TRUE(std::equal(set.begin(), set.end(), ref_set.begin(), ref_set.end()));
+	EXPECT_EQ(map.size(), ref_map.size());
+	auto r = ref_map.begin();
+	for (auto kv : map)
+	{
+		EXPECT_EQ(kv.first, r->first);
+		EXPECT_EQ(kv.second, r->second);
+		++r;
+	}
+}
+
+TEST(TestCaseName, flat3)
+{
+	// the linear count
+	check_flat<ml::small_flat_set<int, 32>, ml::small_flat_map<int, int, 32>>(1, 40);
+
+	// the binary search
+	check_flat<ml::small_flat_set<int, 32>, ml::small_flat_map<int, int, 32>>(2, 1000);
+
+	// a comparator that isn't std::less takes the binary search at every size
+	struct less
+	{
+		bool operator()(int a, int b) const { return a < b; }
+	};
+	check_flat<ml::small_flat_set<int, 32, less>, ml::small_flat_map<int, int, 32, less>>(3, 40);
+}
+
+TEST(TestCaseName, flat4)
+{
+	// one in its static buffer, one spilled
+	ml::small_flat_set<int, 4> a = { 3, 1, 2 };
+	ml::small_flat_set<int, 4> b = { 9, 8, 7, 6, 5, 4 };
+	const auto spilled = b.data();
+
+	a.swap(b);
+	EXPECT_EQ(a, (ml::small_flat_set<int, 4>{ 4, 5, 6, 7, 8, 9 }));
+	EXPECT_EQ(b, (ml::small_flat_set<int, 4>{ 1, 2, 3 }));
+	EXPECT_EQ(a.data(), spilled);
+	EXPECT_TRUE(b.contains(2));
+
+	ml::small_flat_map<int, int, 4> m = { { 1, 10 }, { 2, 20 } };
+	ml::small_flat_map<int, int, 4> n = { { 5, 50 }, { 6, 60 }, { 7, 70 }, { 8, 80 }, { 9, 90 } };
+
+	m.swap(n);
+	EXPECT_EQ(m.size(), 5);
+	EXPECT_EQ(m.at(9), 90);
+	EXPECT_FALSE(m.contains(1));
+	EXPECT_EQ(n.size(), 2);
+	EXPECT_EQ(n.at(2), 20);
+	EXPECT_EQ(n, (ml::small_flat_map<int, int, 4>{ { 2, 20 }, { 1, 10 } }));
+}
@@ -0,0 +1,218 @@
+#include "small_pod_vector_io.hpp"
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <sys/socket.h>
+
+TEST(TestCaseName, io1)
+{
+	int fds[2];
+	ASSERT_EQ(::pipe(fds), 0);
+
+	// small reads land in the static buffer
+	ml::small_pod_vector<char, 64> vec = { 'x' };
+	ASSERT_EQ(::write(fds[1], "hello", 5), 5);
+	EXPECT_EQ(ml::io::read_append(fds[0], vec, 32), 5);
+	EXPECT_EQ(vec.size(), 6);
+	EXPECT_EQ(vec.capacity(), 64);
+	EXPECT_EQ(std::string(vec.begin(), vec.end()), "xhello");
+
+	// larger ones spill once
+	std::string big(1000, 'a');
+	ASSERT_EQ(::write(fds[1], big.data(), big.size()), 1000);
+	EXPECT_EQ(ml::io::read_append(fds[0], vec, 4096), 1000);
+	EXPECT_EQ(vec.size(), 1006);
+	EXPECT_EQ(vec.back(), 'a');
+
+	// several vectors out in one call, back in scattered over several
+	std::vector<ml::small_pod_vector<uint32_t, 4>> out = { { 1, 2, 3 }, {}, { 4, 5, 6, 7, 8 } };
+	EXPECT_EQ(ml::io::writev_all(fds[1], out), 8 * 4);
+
+	ml::small_pod_vector<uint32_t, 4> a, b, c;
+	ml::small_pod_vector<uint32_t, 4>* into[] = { &a, &b, &c };
+	EXPECT_EQ(ml::io::readv_append(fds[0], into, 3, 3), 8 * 4);
+	EXPECT_EQ(a.size(), 3);
+	EXPECT_EQ(b.size(), 3);
+	EXPECT_EQ(c.size(), 2);
+	EXPECT_EQ(a[0], 1);
+	EXPECT_EQ(b[0], 4);
+	EXPECT_EQ(c[1], 8);
+
+	// an element split across writes is completed
+	std::thread writer([&]()
+	{
+		const uint32_t values[2] = { 0x11223344, 0x55667788 };
+		const auto bytes = reinterpret_cast<const char*>(values);
+		EXPECT_EQ(::write(fds[1], bytes, 6), 6);
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		EXPECT_EQ(::write(fds[1], bytes + 6, 2), 2);
+	});
+
+	ml::small_pod_vector<uint32_t, 4> split;
+	EXPECT_EQ(ml::io::read_append(fds[0], split, 16), 8);
+	writer.join();
+	ASSERT_EQ(split.size(), 2);
+	EXPECT_EQ(split[1], 0x55667788);
+
+	// the end of the pipe
+	::close(fds[1]);
+	EXPECT_EQ(ml::io::read_append(fds[0], split, 16), 0);
+	EXPECT_EQ(split.size(), 2);
+	::close(fds[0]);
+}
+
+TEST(TestCaseName, io2)
+{
+	auto f = std::tmpfile();
+	const int fd = fileno(f);
+
+	// many vectors into a file, more than one writev's worth
+	std::vector<ml::small_pod_vector<uint16_t, 8>> vecs(3000);
+	size_t total = 0;
+	for (size_t i = 0; i < vecs.size(); ++i)
+	{
+		vecs[i].resize(i % 20, uint16_t(i));
+		total += vecs[i].size();
+	}
+	EXPECT_EQ(ml::io::writev_all(fd, vecs), ssize_t(total * 2));
+
+	ml::small_pod_vector<uint16_t, 8> back;
+	EXPECT_EQ(ml::io::pread_append(fd, back, total + 100, 0), ssize_t(total * 2));
+	ASSERT_EQ(back.size(), total);
+
+	size_t k = 0;
+	for (size_t i = 0; i < vecs.size(); ++i)
+	{
+		for (auto v : vecs[i])
+		{
+			ASSERT_EQ(back[k++], v);
+		}
+	}
+
+	// from an offset, and a partial element at the end of the file dropped
+	ml::small_pod_vector<uint16_t, 8> part;
+	EXPECT_EQ(ml::io::pread_append(fd, part, 4, off_t(total * 2 - 3)), 3);
+	EXPECT_EQ(part.size(), 1);
+	EXPECT_EQ(part[0], uint16_t(back[total - 2] >> 8 | back[total - 1] << 8));
+
+	// by hand
+	ml::small_pod_vector<uint16_t, 8> manual;
+	const auto iov = ml::io::tail(manual, 4);
+	EXPECT_EQ(::pread(fd, iov.iov_base, iov.iov_len, 0), 8);
+	ml::io::commit(manual, 8);
+	EXPECT_EQ(manual.size(), 4);
+	EXPECT_EQ(manual[3], back[3]);
+
+	std::fclose(f);
+}
+
+TEST(TestCaseName, io3)
+{
+	int fds[2];
+	ASSERT_EQ(::socketpair(AF_UNIX, SOCK_DGRAM, 0, fds), 0);
+
+	// datagrams, one per call
+	ASSERT_EQ(::send(fds[0], "abc", 3, 0), 3);
+	ASSERT_EQ(::send(fds[0], "defgh", 5, 0), 5);
+
+	ml::small_pod_vector<char, 16> vec;
+	EXPECT_EQ(ml::io::recvmsg_append(fds[1], vec, 16), 3);
+	EXPECT_EQ(ml::io::recvmsg_append(fds[1], vec, 16), 5);
+	EXPECT_EQ(std::string(vec.begin(), vec.end()), "abcdefgh");
+
+	// too long for the room given
+	ASSERT_EQ(::send(fds[0], "0123456789", 10, 0), 10);
+	msghdr msg = {};
+	EXPECT_EQ(ml::io::recvmsg_append(fds[1], vec, 4, 0, &msg), 4);
+	EXPECT_TRUE(msg.msg_flags & MSG_TRUNC);
+	EXPECT_EQ(vec.size(), 12);
+	EXPECT_EQ(vec.back(), '3');
+
+	::close(fds[0]);
+	::close(fds[1]);
+}
+
+
+// below RevertToStaticSize reserve() leaves the elements in the static buffer, the tail must not
+TEST(TestCaseName, io4)
+{
+	int fds[2];
+	ASSERT_EQ(::pipe(fds), 0);
+
+	std::string big(100, 'b');
+	ASSERT_EQ(::write(fds[1], big.data(), big.size()), 100);
+
+	ml::small_pod_vector<char, 16, 8> vec = { 'x' };
+	EXPECT_EQ(ml::io::read_append(fds[0], vec, 100), 100);
+	EXPECT_EQ(vec.size(), 101);
+	EXPECT_GE(vec.capacity(), 101);
+	EXPECT_EQ(vec.front(), 'x');
+	EXPECT_EQ(std::string(vec.begin() + 1, vec.end()), big);
+
+	// scattered into several, each below its revert size
+	ASSERT_EQ(::write(fds[1], big.data(), 60), 60);
+	ml::small_pod_vector<char, 16, 8> a = { 'a' }, b;
+	ml::small_pod_vector<char, 16, 8>* into[] = { &a, &b };
+	EXPECT_EQ(ml::io::readv_append(fds[0], into, 2, 40), 60);
+	EXPECT_EQ(a.size(), 41);
+	EXPECT_EQ(b.size(), 20);
+	EXPECT_EQ(a.back(), 'b');
+	EXPECT_EQ(b.back(), 'b');
+
+	ASSERT_EQ(::write(fds[1], big.data(), 30), 30);
+	ml::small_pod_vector<char, 16, 8> c;
+	EXPECT_EQ(ml::io::read_append(fds[0], c, 30), 30);
+	EXPECT_EQ(c.size(), 30);
+
+	::close(fds[0]);
+	::close(fds[1]);
+
+	ASSERT_EQ(::socketpair(AF_UNIX, SOCK_DGRAM, 0, fds), 0);
+	ASSERT_EQ(::send(fds[0], big.data(), 50, 0), 50);
+	ml::small_pod_vector<char, 16, 8> d;
+	EXPECT_EQ(ml::io::recvmsg_append(fds[1], d, 64), 50);
+	EXPECT_EQ(d.size(), 50);
+
+	// a read ending below the revert size keeps what arrived
+	const int pair[] = { 41, 42 };
+	ASSERT_EQ(::send(fds[0], pair, sizeof(pair), 0), ssize_t(sizeof(pair)));
+	ml::small_pod_vector<int, 8, 5> e = { 7 };
+	EXPECT_EQ(ml::io::recvmsg_append(fds[1], e, 16), 8);
+	EXPECT_EQ(std::vector<int>(e.begin(), e.end()), (std::vector<int>{ 7, 41, 42 }));
+
+	::close(fds[0]);
+	::close(fds[1]);
+
+	// the same for read, pread and readv
+	ASSERT_EQ(::pipe(fds), 0);
+	ASSERT_EQ(::write(fds[1], pair, sizeof(pair)), ssize_t(sizeof(pair)));
+	ml::small_pod_vector<int, 8, 5> g = { 7 };
+	EXPECT_EQ(ml::io::read_append(fds[0], g, 16), 8);
+	ASSERT_EQ(g.size(), 3);
+	EXPECT_EQ(g[0], 7);
+	EXPECT_EQ(g[1], 41);
+	EXPECT_EQ(g[2], 42);
+
+	ASSERT_EQ(::write(fds[1], pair, sizeof(pair)), ssize_t(sizeof(pair)));
+	ml::small_pod_vector<int, 8, 5> h = { 7 }, k;
+	ml::small_pod_vector<int, 8, 5>* both[] = { &h, &k };
+	EXPECT_EQ(ml::io::readv_append(fds[0], both, 2, 1), 8);
+	EXPECT_EQ(std::vector<int>(h.begin(), h.end()), (std::vector<int>{ 7, 41 }));
+	EXPECT_EQ(std::vector<int>(k.begin(), k.end()), (std::vector<int>{ 42 }));
+
+	::close(fds[0]);
+	::close(fds[1]);
+
+	auto f = std::tmpfile();
+	ASSERT_EQ(::pwrite(fileno(f), pair, sizeof(pair), 0), ssize_t(sizeof(pair)));
+	ml::small_pod_vector<int, 8, 5> m = { 7 };
+	EXPECT_EQ(ml::io::pread_append(fileno(f), m, 16, 0), 8);
+	EXPECT_EQ(std::vector<int>(m.begin(), m.end()), (std::vector<int>{ 7, 41, 42 }));
+	std::fclose(f);
+}
+
+#endif
@@ -0,0 +1,97 @@
+#define ML_SPV_PROFILE
+
+#include "small_pod_vector_profiler.hpp"
+
+#include <vector>
+
+ML_SPV_PROFILE_SITE(small_site);
+ML_SPV_PROFILE_SITE(wide_site);
+
+namespace
+{
+	const ml::profile::site_report* find_site(const std::vector<ml::profile::site_report>& reports, const char* name)
+	{
+		for (const auto& r : reports)
+		{
+			if (std::strcmp(r.name, name) == 0) return &r;
+		}
+		return nullptr;
+	}
+}
+
+TEST(TestCaseName, profiler1)
+{
+	using small_vec = ml::profile::profiled_vector<int, 4, small_site>;
+	using wide_vec = ml::profile::profiled_vector<uint64_t, 8, wide_site>;
+
+	static_assert(std::is_same<small_vec::stats_policy, ml::profile::site<small_site, sizeof(int), 4>>::value, "");
+
+	// 90 vectors peak at 6, 10 at 100
+	for (int i = 0; i < 100; ++i)
+	{
+		small_vec vec;
+		const int n = i < 90 ? 6 : 100;
+		for (int j = 0; j < n; ++j)
+		{
+			vec.push_back(j);
+		}
+
+		// the peak stays, the size doesn't matter at destruction
+		vec.resize(1);
+	}
+
+	// all of them peak at 40, more than the budget allows
+	for (int i = 0; i < 10; ++i)
+	{
+		wide_vec vec(40);
+	}
+
+	// not counted, never held anything
+	wide_vec empty;
+
+	auto reports = ml::profile::report();
+
+	auto small = find_site(reports, small_site::name());
+	ASSERT_NE(small, nullptr);
+	EXPECT_NE(std::strstr(small->name, "test_small_pod_vector_profiler_.cpp"), nullptr);
+	EXPECT_EQ(small->element_size, sizeof(int));
+	EXPECT_EQ(small->static_capacity, 4);
+	EXPECT_EQ(small->vectors, 100);
+	EXPECT_EQ(small->peaks[6], 90);
+	EXPECT_EQ(small->peaks[100], 10);
+	EXPECT_DOUBLE_EQ(small->spill_rate, 1.0);
+	EXPECT_EQ(small->stats.spills, 100);
+	EXPECT_EQ(small->percentile(0.5), 6);
+	EXPECT_EQ(small->percentile(1.0), 100);
+
+	// 6 leaves 10% spilling, above the 5% allowed, and 100 ints don't fit the 256 byte budget
+	EXPECT_EQ(small->recommended_capacity, 64);
+	EXPECT_DOUBLE_EQ(small->recommended_spill_rate, 0.1);
+
+	ml::profile::options roomy;
+	roomy.inline_budget_bytes = 1024;
+	reports = ml::profile::report(roomy);
+	small = find_site(reports, small_site::name());
+	EXPECT_EQ(small->recommended_capacity, 100);
+	EXPECT_DOUBLE_EQ(small->recommended_spill_rate, 0.0);
+
+	ml::profile::options loose;
+	loose.max_spill_rate = 0.1;
+	reports = ml::profile::report(loose);
+	small = find_site(reports, small_site::name());
+	EXPECT_EQ(small->recommended_capacity, 6);
+	EXPECT_DOUBLE_EQ(small->recommended_spill_rate, 0.1);
+
+	auto wide = find_site(reports, wide_site::name());
+	ASSERT_NE(wide, nullptr);
+	EXPECT_EQ(wide->vectors, 10);
+
+	// capped by the budget, 32 uint64_t
+	EXPECT_EQ(wide->recommended_capacity, 32);
+	EXPECT_DOUBLE_EQ(wide->recommended_spill_rate, 1.0);
+
+	auto out = std::tmpfile();
+	ml::profile::dump(reports, out);
+	EXPECT_GT(std::ftell(out), 0);
+	std::fclose(out);
+}
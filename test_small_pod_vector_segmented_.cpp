@@ -0,0 +1,137 @@
+#include "small_pod_vector_segmented.hpp"
+
+#include <vector>
+
+TEST(TestCaseName, segmented1)
+{
+	ml::segmented_pod_vector<int, 4> vec;
+	std::vector<int> ref;
+
+	vec.push_back(0);
+	const int* first = &vec[0];
+	EXPECT_EQ(vec.capacity(), 4);
+
+	std::vector<const int*> addresses = { first };
+	for (int i = 1; i < 1000; ++i)
+	{
+		vec.push_back(i);
+		addresses.push_back(&vec.back());
+	}
+	for (int i = 0; i < 1000; ++i)
+	{
+		ref.push_back(i);
+	}
+
+	// nothing moved while growing
+	for (int i = 0; i < 1000; ++i)
+	{
+		EXPECT_EQ(&vec[i], addresses[i]);
+	}
+	EXPECT_EQ(vec.capacity(), 1024);
+	EXPECT_TRUE(std::equal(vec.begin(), vec.end(), ref.begin(), ref.end()));
+
+	// a run across segment boundaries
+	int run[300];
+	for (int i = 0; i < 300; ++i)
+	{
+		run[i] = 1000 + i;
+		ref.push_back(1000 + i);
+	}
+	vec.append(run, 300);
+	EXPECT_EQ(vec.size(), 1300);
+	EXPECT_EQ(&vec[999], addresses[999]);
+	EXPECT_TRUE(std::equal(vec.begin(), vec.end(), ref.begin(), ref.end()));
+
+	// random access iterators
+	std::reverse(vec.begin(), vec.end());
+	EXPECT_EQ(vec.front(), 1299);
+	EXPECT_EQ(vec.end() - vec.begin(), 1300);
+	EXPECT_EQ(vec.begin()[1000], 299);
+	std::sort(vec.begin(), vec.end());
+	EXPECT_TRUE(std::equal(vec.begin(), vec.end(), ref.begin(), ref.end()));
+	EXPECT_TRUE(std::equal(vec.rbegin(), vec.rend(), ref.rbegin(), ref.rend()));
+	EXPECT_EQ(*std::lower_bound(vec.cbegin(), vec.cend(), 517), 517);
+
+	// flattened, one memcpy per segment
+	auto flat = vec.to_vector();
+	EXPECT_EQ(flat.size(), 1300);
+	EXPECT_TRUE(std::equal(flat.begin(), flat.end(), ref.begin(), ref.end()));
+
+	size_t segments = 0;
+	vec.for_each_segment([&](const int* p, size_t n) { EXPECT_GT(n, 0); EXPECT_NE(p, nullptr); ++segments; });
+	EXPECT_EQ(segments, 10);
+
+	// ending on a segment boundary, back() is the last of the full segment
+	vec.resize(512);
+	EXPECT_EQ(vec.back(), 511);
+	vec.push_back(-1);
+	EXPECT_EQ(vec[512], -1);
+	vec.pop_back();
+	vec.pop_back();
+	EXPECT_EQ(vec.back(), 510);
+
+	vec.shrink_to_fit();
+	EXPECT_EQ(vec.capacity(), 512);
+
+	vec.clear();
+	EXPECT_TRUE(vec.empty());
+	EXPECT_EQ(vec.capacity(), 512);
+	EXPECT_EQ(vec.begin(), vec.end());
+
+	vec.shrink_to_fit();
+	EXPECT_EQ(vec.capacity(), 4);
+}
+
+TEST(TestCaseName, segmented2)
+{
+	ml::segmented_pod_vector<uint16_t, 8> vec = { 1, 2, 3 };
+
+	vec.resize(100, 7);
+	EXPECT_EQ(vec.size(), 100);
+	EXPECT_EQ(vec[2], 3);
+	EXPECT_EQ(vec[3], 7);
+	EXPECT_EQ(vec[99], 7);
+	EXPECT_EQ(std::count(vec.begin(), vec.end(), 7), 97);
+
+	vec.reserve(1000);
+	EXPECT_EQ(vec.capacity(), 1024);
+	const auto p = &vec[50];
+
+	// the heap segments are taken over
+	auto moved = std::move(vec);
+	EXPECT_EQ(moved.size(), 100);
+	EXPECT_EQ(&moved[50], p);
+	EXPECT_EQ(moved[0], 1);
+	EXPECT_TRUE(vec.empty());
+	EXPECT_EQ(vec.capacity(), 8);
+
+	vec.push_back(5);
+	EXPECT_EQ(vec[0], 5);
+
+	auto copy = moved;
+	EXPECT_EQ(copy.size(), 100);
+	EXPECT_TRUE(std::equal(copy.begin(), copy.end(), moved.begin(), moved.end()));
+	EXPECT_NE(&copy[50], p);
+
+	copy = vec;
+	EXPECT_EQ(copy.size(), 1);
+	EXPECT_EQ(copy[0], 5);
+
+	vec = std::move(moved);
+	EXPECT_EQ(vec.size(), 100);
+	EXPECT_EQ(&vec[50], p);
+
+	// the value may be an element
+	for (int i = 0; i < 1000; ++i)
+	{
+		vec.push_back(vec[2]);
+	}
+	EXPECT_EQ(vec.back(), 3);
+
+	// into an existing vector
+	ml::small_pod_vector<uint16_t, 8> existing = { 9 };
+	vec.append_to(existing);
+	EXPECT_EQ(existing.size(), 1101);
+	EXPECT_EQ(existing[1], 1);
+	EXPECT_EQ(existing[1100], 3);
+}
@@ -0,0 +1,186 @@
+#include "small_pod_vector_serialize.hpp"
+
+#include <cstdio>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	struct point
+	{
+		float x, y, z;
+	};
+}
+
+TEST(TestCaseName, serialize1)
+{
+	ml::small_pod_vector<int, 4> a = { 1, 2, 3, 4, 5 };
+	ml::small_pod_vector<int, 4> empty;
+	std::vector<point> b = { { 1, 2, 3 }, { 4, 5, 6 } };
+
+	EXPECT_EQ(ml::serialize::blob_size<int>(5), 16 + 32);
+	EXPECT_EQ(ml::serialize::blob_size<int>(0), 16);
+
+	ml::small_pod_vector<unsigned char, 16> bytes;
+	ml::serialize::append(bytes, a);
+	ml::serialize::append(bytes, empty);
+	ml::serialize::append(bytes, b);
+	EXPECT_EQ(bytes.size(), 48 + 16 + 16 + 32);
+
+	// copied into a buffer aligned like an mmap'ed file
+	std::vector<uint64_t> aligned(bytes.size() / 8);
+	std::memcpy(aligned.data(), bytes.data(), bytes.size());
+
+	ml::serialize::blob_reader reader(aligned.data(), bytes.size());
+
+	ml::small_pod_vector_view<int> va;
+	ASSERT_TRUE(reader.next(va));
+	EXPECT_EQ(va.size(), 5);
+	EXPECT_EQ(va[4], 5);
+	EXPECT_EQ(va, ml::small_pod_vector_view<int>(a));
+	EXPECT_TRUE(std::equal(va.begin(), va.end(), a.begin(), a.end()));
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(va.data()) % ml::serialize::blob_alignment, 0);
+
+	// pointing into the buffer, no copy
+	EXPECT_EQ(reinterpret_cast<const unsigned char*>(va.data()), reinterpret_cast<const unsigned char*>(aligned.data()) + 16);
+
+	ml::small_pod_vector_view<int> ve;
+	ASSERT_TRUE(reader.next(ve));
+	EXPECT_TRUE(ve.empty());
+
+	ml::small_pod_vector_view<point> vb;
+	ASSERT_TRUE(reader.next(vb));
+	EXPECT_EQ(vb.back().z, 6);
+	EXPECT_TRUE(reader.at_end());
+	EXPECT_FALSE(reader.next(vb));
+	EXPECT_FALSE(reader.failed());
+
+	// the explicit copy out
+	auto owned = va.materialize();
+	EXPECT_EQ(ml::small_pod_vector_view<int>(owned), va);
+	EXPECT_NE(owned.data(), va.data());
+	auto owned_std = vb.materialize<ml::small_pod_vector<point, 1>>();
+	EXPECT_EQ(owned_std.size(), 2);
+	EXPECT_EQ(owned_std[1].x, 4);
+	EXPECT_EQ(std::vector<int>(va.rbegin(), va.rend()), std::vector<int>({ 5, 4, 3, 2, 1 }));
+}
+
+TEST(TestCaseName, serialize2)
+{
+	std::vector<uint64_t> buf(8);
+	const uint32_t values[] = { 7, 8, 9 };
+	const auto n = ml::serialize::write(buf.data(), values, 3);
+	EXPECT_EQ(n, 32);
+
+	ml::small_pod_vector_view<uint32_t> v;
+
+	// truncated
+	{
+		ml::serialize::blob_reader reader(buf.data(), 20);
+		EXPECT_FALSE(reader.next(v));
+		EXPECT_TRUE(reader.failed());
+	}
+
+	// the wrong element type
+	{
+		ml::serialize::blob_reader reader(buf.data(), n);
+		ml::small_pod_vector_view<uint16_t> wrong;
+		EXPECT_FALSE(reader.next(wrong));
+		EXPECT_TRUE(reader.failed());
+		EXPECT_FALSE(reader.next(v));
+	}
+
+	// a size larger than the buffer
+	{
+		auto corrupt = buf;
+		corrupt[0] = uint64_t(1) << 62;
+		ml::serialize::blob_reader reader(corrupt.data(), n);
+		EXPECT_FALSE(reader.next(v));
+		EXPECT_TRUE(reader.failed());
+	}
+
+	// not a blob
+	{
+		auto corrupt = buf;
+		corrupt[1] = 0;
+		ml::serialize::blob_reader reader(corrupt.data(), n);
+		EXPECT_FALSE(reader.next(v));
+	}
+
+	ml::serialize::blob_reader reader(buf.data(), n);
+	EXPECT_TRUE(reader.next(v));
+	EXPECT_EQ(v.size(), 3);
+	EXPECT_EQ(v[2], 9);
+	EXPECT_EQ(reader.remaining(), 0);
+}
+
+#if defined(__linux__)
+TEST(TestCaseName, serialize3)
+{
+	// through a file, read back from a mapping of it
+	ml::small_pod_vector<unsigned char> bytes;
+	std::vector<ml::small_pod_vector<double, 4>> vecs;
+	for (int i = 0; i < 100; ++i)
+	{
+		vecs.emplace_back();
+		for (int j = 0; j < i; ++j)
+		{
+			vecs.back().push_back(i + j * 0.5);
+		}
+		ml::serialize::append(bytes, vecs.back());
+	}
+
+	auto f = std::tmpfile();
+	ASSERT_EQ(std::fwrite(bytes.data(), 1, bytes.size(), f), bytes.size());
+	std::fflush(f);
+
+	auto map = ::mmap(nullptr, bytes.size(), PROT_READ, MAP_PRIVATE, fileno(f), 0);
+	ASSERT_NE(map, MAP_FAILED);
+
+	ml::serialize::blob_reader reader(map, bytes.size());
+	ml::small_pod_vector_view<double> v;
+	size_t count = 0;
+	while (reader.next(v))
+	{
+		EXPECT_EQ(v, ml::small_pod_vector_view<double>(vecs[count]));
+		++count;
+	}
+	EXPECT_FALSE(reader.failed());
+	EXPECT_EQ(count, 100);
+
+	::munmap(map, bytes.size());
+	std::fclose(f);
+}
+#endif
+
+// nothing to copy: a default view and an empty std::vector (data() is null) round trip
+TEST(TestCaseName, serialize4)
+{
+	ml::small_pod_vector_view<int> none;
+	EXPECT_TRUE(none.empty());
+	const auto copy = none.materialize();
+	EXPECT_TRUE(copy.empty());
+	EXPECT_EQ(none, ml::small_pod_vector_view<int>(copy));
+
+	const std::vector<int> empty;
+	ml::small_pod_vector<unsigned char, 16> bytes;
+	ml::serialize::append(bytes, empty);
+	EXPECT_EQ(bytes.size(), 16);
+
+	std::vector<uint64_t> aligned(bytes.size() / 8);
+	std::memcpy(aligned.data(), bytes.data(), bytes.size());
+
+	ml::serialize::blob_reader reader(aligned.data(), bytes.size());
+	ml::small_pod_vector_view<int> v;
+	ASSERT_TRUE(reader.next(v));
+	EXPECT_TRUE(v.empty());
+	EXPECT_TRUE(v.materialize().empty());
+	EXPECT_EQ(v, none);
+	EXPECT_TRUE(reader.at_end());
+	EXPECT_FALSE(reader.next(v));
+	EXPECT_FALSE(reader.failed());
+}
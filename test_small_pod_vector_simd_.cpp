@@ -0,0 +1,116 @@
+#include "small_pod_vector_simd.hpp"
+
+#include <limits>
+#include <numeric>
+#include <vector>
+
+// runs f once per instruction set the cpu supports
+template <typename F>
+void for_each_isa(F f)
+{
+	const auto detected = ml::simd::set_isa(ml::simd::isa::avx512);
+
+	for (auto level : { ml::simd::isa::scalar, ml::simd::isa::sse2, ml::simd::isa::avx2, ml::simd::isa::avx512 })
+	{
+		if (level > detected) break;
+
+		ml::simd::set_isa(level);
+		f();
+	}
+
+	ml::simd::set_isa(detected);
+}
+
+// checks every kernel against the std algorithms, on sizes around the vector widths
+template <typename T>
+void compare_with_std(unsigned seed)
+{
+	srand(seed);
+
+	for (size_t n = 0; n < 300; n += 1 + n / 16)
+	{
+		ml::small_pod_vector<T, 8> vec;
+		for (size_t i = 0; i < n; ++i)
+		{
+			// few distinct values, so there are matches
+			vec.push_back(T(rand() % 23));
+		}
+		const std::vector<T> ref(vec.begin(), vec.end());
+		const auto value = T(rand() % 23);
+
+		for_each_isa([&]
+		{
+			EXPECT_EQ(ml::simd::find(vec, value) - vec.begin(), std::find(ref.begin(), ref.end(), value) - ref.begin());
+			EXPECT_EQ(ml::simd::count(vec, value), size_t(std::count(ref.begin(), ref.end(), value)));
+			EXPECT_EQ(ml::simd::sum(vec), std::accumulate(ref.begin(), ref.end(), ml::simd::sum_type<T>(0)));
+
+			if (n > 0)
+			{
+				EXPECT_EQ(ml::simd::min_value(vec), *std::min_element(ref.begin(), ref.end()));
+				EXPECT_EQ(ml::simd::max_value(vec), *std::max_element(ref.begin(), ref.end()));
+			}
+
+			auto other = vec;
+			EXPECT_TRUE(ml::simd::equal(vec, other));
+			if (n > 0)
+			{
+				other[rand() % n] = T(100);
+				EXPECT_FALSE(ml::simd::equal(vec, other));
+			}
+
+			auto less = vec;
+			const auto removed = ml::simd::erase_if(less, ml::simd::compare::less, value);
+			std::vector<T> ref_less = ref;
+			ref_less.erase(std::remove_if(ref_less.begin(), ref_less.end(), [&](T v) { return v < value; }), ref_less.end());
+			EXPECT_EQ(removed, ref.size() - ref_less.size());
+			ASSERT_EQ(less.size(), ref_less.size());
+			EXPECT_TRUE(std::equal(ref_less.begin(), ref_less.end(), less.begin()));
+
+			auto not_equal = vec;
+			ml::simd::erase_if(not_equal, ml::simd::compare::not_equal, value);
+			EXPECT_EQ(not_equal.size(), size_t(std::count(ref.begin(), ref.end(), value)));
+			EXPECT_EQ(std::count(not_equal.begin(), not_equal.end(), value), std::ptrdiff_t(not_equal.size()));
+		});
+	}
+}
+
+TEST(TestCaseName, simd1)
+{
+	for (unsigned seed = 0; seed < 5; ++seed)
+	{
+		compare_with_std<int32_t>(seed);
+		compare_with_std<int64_t>(seed);
+		compare_with_std<uint8_t>(seed);
+		compare_with_std<float>(seed);
+		compare_with_std<double>(seed);
+	}
+}
+
+TEST(TestCaseName, simd2)
+{
+	// long runs overflow narrow lanes if they aren't flushed
+	std::vector<uint8_t> bytes(100000, 200);
+	std::vector<int32_t> ints(100000, 1 << 30);
+
+	for_each_isa([&]
+	{
+		EXPECT_EQ(ml::simd::count(bytes.data(), bytes.size(), uint8_t(200)), bytes.size());
+		EXPECT_EQ(ml::simd::sum(bytes.data(), bytes.size()), 200u * bytes.size());
+		EXPECT_EQ(ml::simd::sum(ints.data(), ints.size()), int64_t(1 << 30) * int64_t(ints.size()));
+	});
+
+	// element wise ==, not bitwise
+	const double a[] = { 0.0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+	const double b[] = { -0.0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+	double nan[10];
+	std::fill(nan, nan + 10, std::numeric_limits<double>::quiet_NaN());
+
+	for_each_isa([&]
+	{
+		EXPECT_TRUE(ml::simd::equal(a, b, 10));
+		EXPECT_FALSE(ml::simd::equal(nan, nan, 10));
+		EXPECT_EQ(ml::simd::find(a, 10, -0.0), 0);
+	});
+
+	EXPECT_LE(ml::simd::get_isa(), ml::simd::isa::avx512);
+}
@@ -0,0 +1,98 @@
+#include "small_pod_vector_stats.hpp"
+
+#include <thread>
+#include <vector>
+
+template <typename Tag, size_t RevertToStaticSize = 0>
+using statsvec = ml::small_pod_vector<int, 4, RevertToStaticSize, ml::impl::pod_allocator, ml::growth::doubling, ml::layout::pointers, ml::retention::release, ml::stats::counting<Tag>>;
+
+TEST(TestCaseName, stats1)
+{
+	// the default records nothing and takes no space
+	static_assert(sizeof(ml::small_pod_vector<int, 4>) == sizeof(ml::small_pod_vector<int, 4, 0, ml::impl::pod_allocator, ml::growth::tight_spill, ml::layout::pointers, ml::retention::keep, ml::stats::none>), "");
+	static_assert(sizeof(ml::sso_pod_vector<int, 32, ml::impl::pod_allocator, ml::growth::doubling, ml::stats::none>) == 32, "");
+
+	struct tag;
+	using counting = ml::stats::counting<tag>;
+
+	{
+		statsvec<tag, 3> vec;
+		for (int i = 0; i < 10; ++i)
+		{
+			vec.push_back(i);
+		}
+
+		const auto s = counting::snapshot();
+
+		// 4 static elements copied out when the fifth came, then grown to 8 and 16
+		EXPECT_EQ(s.spills, 1);
+		EXPECT_EQ(s.allocations, 1);
+		EXPECT_EQ(s.reallocations, 1);
+		EXPECT_GE(s.bytes_copied, 4 * sizeof(int));
+		EXPECT_EQ(s.vectors, 0);
+
+		vec.erase(vec.begin() + 2, vec.end());
+
+		// back in the static buffer, the dynamic one released
+		EXPECT_EQ(counting::snapshot().reverts, 1);
+		EXPECT_EQ(counting::snapshot().frees, 1);
+	}
+
+	const auto s = counting::snapshot();
+
+	EXPECT_EQ(s.vectors, 1);
+	EXPECT_EQ(s.peak_sizes[ml::stats::peak_bucket(10)], 1);
+	EXPECT_EQ(ml::stats::peak_bucket(1), 0);
+	EXPECT_EQ(ml::stats::peak_bucket(2), 1);
+	EXPECT_EQ(ml::stats::peak_bucket(9), 4);
+	EXPECT_EQ(ml::stats::peak_bucket(16), 4);
+	EXPECT_EQ(ml::stats::peak_bucket(size_t(1) << 40), ml::stats::peak_buckets - 1);
+}
+
+TEST(TestCaseName, stats2)
+{
+	struct tag;
+	using counting = ml::stats::counting<tag>;
+
+	{
+		// the move constructor isn't noexcept, a reallocating std::vector would copy (and count) them
+		std::vector<statsvec<tag>> vecs;
+		vecs.reserve(3);
+
+		// the moved-from temporaries aren't counted, and neither is an empty vector
+		for (int i = 0; i < 3; ++i)
+		{
+			vecs.push_back(statsvec<tag>{ 1, 2 });
+		}
+		statsvec<tag> empty;
+
+		auto copy = vecs[0];
+		copy.push_back(3);
+	}
+
+	auto s = counting::snapshot();
+	EXPECT_EQ(s.vectors, 4);
+	EXPECT_EQ(s.peak_sizes[ml::stats::peak_bucket(2)], 3);
+	EXPECT_EQ(s.peak_sizes[ml::stats::peak_bucket(3)], 1);
+	EXPECT_EQ(s.spills, 0);
+
+	// counts of other threads are summed
+	std::thread([]()
+	{
+		statsvec<tag> vec{ 1,2,3,4,5 };
+	}).join();
+
+	s = counting::snapshot();
+	EXPECT_EQ(s.vectors, 5);
+	EXPECT_EQ(s.allocations, 1);
+	EXPECT_EQ(s.frees, 1);
+
+	// another tag counts on its own
+	struct other;
+	EXPECT_EQ(ml::stats::counting<other>::snapshot().vectors, 0);
+
+	auto out = std::tmpfile();
+	ml::stats::dump(s, "stats2", out);
+	EXPECT_GT(std::ftell(out), 0);
+	std::fclose(out);
+}
@@ -0,0 +1,238 @@
+// the pin checks are asserts, on in this test whatever the build type
+#undef NDEBUG
+#define ML_SPV_CHECK_PINS 1
+
+#include "small_pod_vector_uring.hpp"
+
+#include <cstdio>
+#include <vector>
+
+#ifdef ML_SPV_HAS_URING
+
+TEST(TestCaseName, uring1)
+{
+	ml::uring::ring ring(8);
+	if (!ring.valid())
+	{
+		GTEST_SKIP() << "io_uring unavailable: " << std::strerror(ring.error());
+	}
+
+	auto f = std::tmpfile();
+	const int fd = fileno(f);
+
+	// many writes, more than the ring holds at once
+	std::vector<ml::small_pod_vector<uint32_t, 16>> out(100);
+	size_t written = 0;
+	off_t offset = 0;
+	for (uint32_t i = 0; i < out.size(); ++i)
+	{
+		out[i].resize(64, i);
+		ring.write(fd, out[i], offset, [&written](ssize_t r) { EXPECT_EQ(r, 256); written += size_t(r); });
+		offset += 256;
+	}
+	ring.drain();
+	EXPECT_EQ(written, 100 * 256);
+	EXPECT_EQ(ring.in_flight(), 0);
+
+	// read back in batches, into the tails of vectors that already hold something
+	std::vector<ml::small_pod_vector<uint32_t, 16>> in(100, ml::small_pod_vector<uint32_t, 16>{ 7 });
+	size_t completed = 0;
+	for (size_t i = 0; i < in.size(); ++i)
+	{
+		ring.read_append(fd, in[i], 64, off_t(i * 256), [&completed](ssize_t r) { EXPECT_EQ(r, 256); ++completed; });
+	}
+	ring.drain();
+	EXPECT_EQ(completed, 100);
+
+	for (uint32_t i = 0; i < in.size(); ++i)
+	{
+		ASSERT_EQ(in[i].size(), 65);
+		EXPECT_EQ(in[i][0], 7);
+		EXPECT_EQ(in[i][1], i);
+		EXPECT_EQ(in[i][64], i);
+	}
+
+	// past the end of the file
+	ml::small_pod_vector<uint32_t, 16> eof;
+	ssize_t result = -1;
+	ring.read_append(fd, eof, 64, offset, [&result](ssize_t r) { result = r; });
+	EXPECT_EQ(ring.wait(), 1);
+	EXPECT_EQ(result, 0);
+	EXPECT_TRUE(eof.empty());
+
+	// a bad descriptor completes with -errno
+	ring.read_append(-1, eof, 4, 0, [&result](ssize_t r) { result = r; });
+	ring.drain();
+	EXPECT_EQ(result, -EBADF);
+
+	std::fclose(f);
+}
+
+TEST(TestCaseName, uring2)
+{
+	ml::uring::ring ring;
+	if (!ring.valid())
+	{
+		GTEST_SKIP() << "io_uring unavailable: " << std::strerror(ring.error());
+	}
+
+	auto f = std::tmpfile();
+	const int fd = fileno(f);
+	ASSERT_EQ(::pwrite(fd, "0123456789", 10, 0), 10);
+
+	// while the read is in flight the buffer is pinned
+	ml::small_pod_vector<char, 4> vec;
+	ring.read_append(fd, vec, 100, 0, [](ssize_t) {});
+	EXPECT_TRUE(ml::impl::is_pinned(vec.data()));
+	EXPECT_DEATH(vec.reserve(1000), "is_pinned");
+	ring.drain();
+	EXPECT_FALSE(ml::impl::is_pinned(vec.data()));
+	EXPECT_EQ(std::string(vec.begin(), vec.end()), "0123456789");
+
+	vec.reserve(1000);
+
+	std::fclose(f);
+}
+
+// below RevertToStaticSize the read still gets room it may write to
+TEST(TestCaseName, uring4)
+{
+	ml::uring::ring ring;
+	if (!ring.valid())
+	{
+		GTEST_SKIP() << "io_uring unavailable: " << std::strerror(ring.error());
+	}
+
+	auto f = std::tmpfile();
+	const int fd = fileno(f);
+	const std::string data(100, 'u');
+	ASSERT_EQ(::pwrite(fd, data.data(), data.size(), 0), 100);
+
+	ml::small_pod_vector<char, 16, 8> vec = { 'x' };
+	ssize_t result = 0;
+	ring.read_append(fd, vec, 100, 0, [&result](ssize_t r) { result = r; });
+	EXPECT_GE(vec.capacity(), 101);
+	ring.drain();
+
+	EXPECT_EQ(result, 100);
+	EXPECT_EQ(vec.size(), 101);
+	EXPECT_EQ(vec.front(), 'x');
+	EXPECT_EQ(std::string(vec.begin() + 1, vec.end()), data);
+
+	// and keeps what arrived when the vector stays below RevertToStaticSize
+	const int pair[] = { 41, 42 };
+	ASSERT_EQ(::pwrite(fd, pair, sizeof(pair), 100), ssize_t(sizeof(pair)));
+
+	ml::small_pod_vector<int, 8, 5> ints = { 7 };
+	ring.read_append(fd, ints, 16, 100, [&result](ssize_t r) { result = r; });
+	ring.drain();
+
+	EXPECT_EQ(result, 8);
+	EXPECT_EQ(std::vector<int>(ints.begin(), ints.end()), (std::vector<int>{ 7, 41, 42 }));
+
+	std::fclose(f);
+}
+
+// a ring of one entry, every operation after the first waits for room
+TEST(TestCaseName, uring5)
+{
+	ml::uring::ring ring(1);
+	if (!ring.valid())
+	{
+		GTEST_SKIP() << "io_uring unavailable: " << std::strerror(ring.error());
+	}
+
+	auto f = std::tmpfile();
+	const int fd = fileno(f);
+	ASSERT_EQ(::pwrite(fd, "0123456789", 10, 0), 10);
+
+	std::vector<ml::small_pod_vector<char, 4>> in(10);
+	int failed = 0;
+	for (size_t i = 0; i < in.size(); ++i)
+	{
+		ring.read_append(fd, in[i], 1, off_t(i), [&failed](ssize_t r) { failed += r != 1; });
+		EXPECT_LE(ring.in_flight(), 2);
+	}
+	ring.drain();
+	EXPECT_EQ(failed, 0);
+
+	for (size_t i = 0; i < in.size(); ++i)
+	{
+		ASSERT_EQ(in[i].size(), 1);
+		EXPECT_EQ(in[i][0], char('0' + i));
+	}
+
+	std::fclose(f);
+}
+
+#ifdef ML_SPV_URING_COROUTINES
+
+namespace
+{
+	// runs eagerly to the first co_await, the ring resumes it
+	struct task
+	{
+		struct promise_type
+		{
+			task get_return_object() { return {}; }
+			std::suspend_never initial_suspend() noexcept { return {}; }
+			std::suspend_never final_suspend() noexcept { return {}; }
+			void return_void() {}
+			void unhandled_exception() { std::terminate(); }
+		};
+	};
+
+	task copy_file(ml::uring::ring& ring, int from, int to, size_t& copied)
+	{
+		ml::small_pod_vector<char, 64> chunk;
+		off_t offset = 0;
+
+		for (;;)
+		{
+			chunk.clear();
+			const auto r = co_await ring.async_read_append(from, chunk, 4096, offset);
+			if (r <= 0) break;
+
+			const auto w = co_await ring.async_write(to, chunk, offset);
+			EXPECT_EQ(w, r);
+
+			offset += r;
+			copied += size_t(r);
+		}
+	}
+}
+
+TEST(TestCaseName, uring3)
+{
+	ml::uring::ring ring;
+	if (!ring.valid())
+	{
+		GTEST_SKIP() << "io_uring unavailable: " << std::strerror(ring.error());
+	}
+
+	auto from = std::tmpfile();
+	auto to = std::tmpfile();
+
+	std::vector<char> data(10000);
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = char(i * 7);
+	}
+	ASSERT_EQ(::pwrite(fileno(from), data.data(), data.size(), 0), ssize_t(data.size()));
+
+	size_t copied = 0;
+	copy_file(ring, fileno(from), fileno(to), copied);
+	ring.drain();
+	EXPECT_EQ(copied, data.size());
+
+	std::vector<char> back(data.size());
+	ASSERT_EQ(::pread(fileno(to), back.data(), back.size(), 0), ssize_t(back.size()));
+	EXPECT_EQ(back, data);
+
+	std::fclose(from);
+	std::fclose(to);
+}
+
+#endif
+
+#endif